@@ -0,0 +1,35 @@
+# Generates a C++ source with the given asset files compiled in as byte arrays.
+# Usage: cmake -DOUTPUT=<file.cpp> -DASSET_ROOT=<dir> -DASSETS=<a|b|...> -P embed_assets.cmake
+# Asset names are paths relative to ASSET_ROOT, separated with '|' so they survive custom command quoting.
+
+string(REPLACE "|" ";" ASSETS "${ASSETS}")
+
+set(content "// Generated by cmake/embed_assets.cmake, do not edit\n\n#include \"embedded_assets.h\"\n\n")
+set(table "")
+set(index 0)
+
+foreach(asset IN LISTS ASSETS)
+    file(READ "${ASSET_ROOT}/${asset}" hex HEX)
+    # Split into lines of 32 bytes (64 hex digits) to keep the generated file readable
+    string(LENGTH "${hex}" hexLength)
+    math(EXPR size "${hexLength} / 2")
+    set(lines "")
+    set(offset 0)
+    while(offset LESS hexLength)
+        string(SUBSTRING "${hex}" ${offset} 64 line)
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," line "${line}")
+        string(APPEND lines "    ${line}\n")
+        math(EXPR offset "${offset} + 64")
+    endwhile()
+    string(APPEND content "alignas(16) static const unsigned char asset${index}[] = {\n${lines}};\n\n")
+    string(APPEND table "    {\"${asset}\", asset${index}, ${size}},\n")
+    math(EXPR index "${index} + 1")
+endforeach()
+
+string(APPEND content "extern const EmbeddedAsset embeddedAssets[] = {\n${table}};\n\n")
+string(APPEND content "extern const size_t embeddedAssetCount = ${index};\n")
+
+file(WRITE "${OUTPUT}.tmp" "${content}")
+# Only touch the output when something changed, so dependent objects are not rebuilt for nothing
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+// Heap allocations made through the global operator new by any thread. Linking the allocationcounter
+// library replaces operator new with a counting one (two relaxed atomic adds per allocation), so only
+// seekBarBench and SEEKBAR_ALLOCATION_CHECKS builds do. Skia's own sk_malloc buffers are not counted.
+uint64_t allocationCount();
+uint64_t allocatedBytes();
+
+// Stores the allocations made during its lifetime into result when it goes out of scope, e.g. to
+// check that a steady-state frame stayed off the heap
+class AllocationScope {
+public:
+    explicit AllocationScope(uint64_t& result)
+        : _result{result}
+        , _start{allocationCount()} {
+    }
+
+    ~AllocationScope() {
+        _result = allocationCount() - _start;
+    }
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    uint64_t& _result;
+    uint64_t _start;
+};
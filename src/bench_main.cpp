@@ -0,0 +1,407 @@
+#include "allocation_counter.h"
+#include "image_provider.h"
+#include "seek_bar.h"
+#include "seek_bar_layout.h"
+#include "seek_bar_model.h"
+#include "utils.h"
+
+#include "include/core/SkSurface.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+constexpr int benchWidth = 960;
+constexpr int benchHeight = 640;
+constexpr double defaultMinTime = 0.1; // Seconds every repetition runs for at least
+constexpr int defaultRepetitions = 5;
+constexpr size_t maxIterations = size_t{1} << 30;
+constexpr std::array<size_t, 6> chapterCounts = {4, 64, 1000, 10000, 50000, 100000};
+constexpr int steadyStateWarmupFrames = 8; // Caches, layers and the frame arena settle within these
+constexpr int steadyStateFrames = 240;
+constexpr double sweepStep = 7.0; // Logical units the mouse moves per iteration, not a divisor of the bar width
+
+namespace {
+
+enum class OutputFormat {
+    Json,
+    Csv
+};
+
+struct BenchResult {
+    std::string name;
+    size_t iterations = 0;          // Per repetition
+    double nsPerOp = 0.0;           // Median over the repetitions
+    double minNsPerOp = 0.0;
+    double allocationsPerOp = 0.0;
+    double allocatedBytesPerOp = 0.0;
+};
+
+// Runs every case until a repetition takes at least minTime, then times the repetitions. The
+// operation gets a running iteration number, so cases can vary their input from call to call.
+class BenchRunner {
+public:
+    BenchRunner(const double minTime, const int repetitions, std::string filter)
+        : _minTime{minTime}
+        , _repetitions{repetitions}
+        , _filter{std::move(filter)} {
+    }
+
+    void run(const std::string& name, const std::function<void(size_t)>& operation) {
+        if (!_filter.empty() && name.find(_filter) == std::string::npos) {
+            return;
+        }
+
+        size_t iteration = 0;
+        operation(iteration++); // Warm up caches and lazily created resources
+
+        size_t iterations = 1;
+        while (timeIterations(operation, iterations, iteration) < _minTime && iterations < maxIterations) {
+            iterations *= 2;
+        }
+
+        std::vector<double> nsPerOp;
+        const uint64_t allocationsBefore = allocationCount();
+        const uint64_t bytesBefore = allocatedBytes();
+        for (int repetition = 0; repetition < _repetitions; ++repetition) {
+            nsPerOp.push_back(timeIterations(operation, iterations, iteration) * 1e9 / iterations);
+        }
+        const double operations = static_cast<double>(iterations) * _repetitions;
+        const double allocations = static_cast<double>(allocationCount() - allocationsBefore);
+        const double bytes = static_cast<double>(allocatedBytes() - bytesBefore);
+
+        std::sort(nsPerOp.begin(), nsPerOp.end());
+        BenchResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.nsPerOp = nsPerOp[nsPerOp.size() / 2];
+        result.minNsPerOp = nsPerOp.front();
+        result.allocationsPerOp = allocations / operations;
+        result.allocatedBytesPerOp = bytes / operations;
+        std::cerr << name << ": " << result.nsPerOp << " ns/op, " << result.allocationsPerOp << " allocation(s)/op" << std::endl;
+        _results.push_back(std::move(result));
+    }
+
+    const std::vector<BenchResult>& results() const {
+        return _results;
+    }
+
+private:
+    static double timeIterations(const std::function<void(size_t)>& operation, const size_t iterations, size_t& iteration) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) {
+            operation(iteration++);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double _minTime;
+    int _repetitions;
+    std::string _filter;
+    std::vector<BenchResult> _results;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--format json|csv] [--output <results>] [--filter <substring>]\n"
+              << "       [--min-time <seconds>] [--repetitions N]\n"
+              << "\n"
+              << "Times the seek bar hot paths on a " << benchWidth << "x" << benchHeight << " raster surface, then\n"
+              << "fails if a steady-state frame (playback, hover, loading, HUD) touches the heap.\n";
+}
+
+std::vector<Chapter> makeChapters(const size_t count) {
+    std::vector<Chapter> chapters;
+    chapters.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        chapters.push_back({
+            .label = "Chapter " + std::to_string(i + 1),
+            .start = static_cast<double>(i) / count,
+            .end = static_cast<double>(i + 1) / count});
+    }
+    return chapters;
+}
+
+SeekBarModel makeLoadedModel(const size_t chapterCount) {
+    SeekBarModel model{benchWidth, benchHeight};
+    model.startLoading();
+    model.finishLoading(makeChapters(chapterCount), SeekBarContent::placeholder()->duration, nullptr);
+    model.setCursorVisibility(true);
+    return model;
+}
+
+// Sweeps the mouse back and forth over the bar, hitting a different spot on most iterations
+double sweepX(const SeekBarLayout& layout, const size_t iteration) {
+    const double offset = std::fmod(iteration * sweepStep, 2.0 * layout.width);
+    return layout.padding + (offset <= layout.width ? offset : 2.0 * layout.width - offset);
+}
+
+void benchDraw(BenchRunner& runner, SeekBar& bar, const std::string& name, const std::function<SeekBarState(size_t)>& state) {
+    runner.run(name, [&](const size_t iteration) {
+        bar.applyState(state(iteration));
+        // Measure the whole frame, an unchanged state would otherwise draw nothing
+        bar.invalidate();
+        bar.draw();
+    });
+}
+
+void runDrawBenchmarks(BenchRunner& runner) {
+    auto surface = SkSurfaces::Raster(SkImageInfo::Make(benchWidth, benchHeight, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    if (!surface) {
+        throw std::runtime_error("Failed to create raster surface");
+    }
+    SeekBar bar{surface->getCanvas(), benchWidth, benchHeight};
+    const SeekBarLayout layout{benchWidth, benchHeight};
+
+    const SeekBarModel defaultModel{benchWidth, benchHeight};
+    benchDraw(runner, bar, "draw/default", [&](size_t) {
+        return defaultModel.state();
+    });
+
+    SeekBarModel loadingModel{benchWidth, benchHeight};
+    loadingModel.startLoading();
+    benchDraw(runner, bar, "draw/loading", [&](const size_t iteration) {
+        loadingModel.setLoadingProgress(static_cast<double>(iteration % 100) / 100.0);
+        return loadingModel.state();
+    });
+
+    SeekBarModel loadedModel = makeLoadedModel(SeekBarContent::placeholder()->chapters.size());
+    loadedModel.setCursorVisibility(false);
+    benchDraw(runner, bar, "draw/loaded", [&](size_t) {
+        return loadedModel.state();
+    });
+
+    SeekBarModel hoveredModel = makeLoadedModel(SeekBarContent::placeholder()->chapters.size());
+    benchDraw(runner, bar, "draw/hovered", [&](const size_t iteration) {
+        hoveredModel.setHoverForChapter(sweepX(layout, iteration));
+        return hoveredModel.state();
+    });
+
+    SeekBarModel draggingModel = makeLoadedModel(SeekBarContent::placeholder()->chapters.size());
+    draggingModel.startCursorDragging();
+    benchDraw(runner, bar, "draw/dragging", [&](const size_t iteration) {
+        const double x = sweepX(layout, iteration);
+        draggingModel.updateCursorPosition(x);
+        draggingModel.setHoverForChapter(x);
+        return draggingModel.state();
+    });
+
+    // Chapter outlines and hover labels with a realistic to absurd chapter count
+    for (const size_t count : chapterCounts) {
+        SeekBarModel model = makeLoadedModel(count);
+        benchDraw(runner, bar, "draw/hovered/chapters=" + std::to_string(count), [&](const size_t iteration) {
+            model.setHoverForChapter(sweepX(layout, iteration));
+            return model.state();
+        });
+    }
+}
+
+// Frames whose state changes only in ways the renderer handles without rebuilding anything. After the
+// warm-up every applyState() + draw() must stay off the heap; returns the number of frames that did not.
+int checkSteadyStateFrames(const std::string& filter) {
+    auto surface = SkSurfaces::Raster(SkImageInfo::Make(benchWidth, benchHeight, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    if (!surface) {
+        throw std::runtime_error("Failed to create raster surface");
+    }
+    const auto content = SeekBarContent::placeholder();
+
+    SeekBarState loaded;
+    loaded.content = content;
+    loaded.isPlaying = true;
+
+    const std::array<std::pair<const char*, std::function<SeekBarState(int)>>, 4> cases = {{
+        {"steady/playback", [&](const int frame) {
+            SeekBarState state = loaded;
+            state.cursorTime = frame / 60.0;
+            return state;
+        }},
+        {"steady/hover", [&](const int frame) {
+            // The mouse moves through a chapter, then on to the next one; the cached layers stay valid
+            SeekBarState state = loaded;
+            const size_t index = static_cast<size_t>(frame / 20) % content->chapters.size();
+            const Chapter& hovered = content->chapters[index];
+            const double span = (hovered.end - hovered.start) * content->duration;
+            state.hoveredChapter = static_cast<int>(index);
+            state.hoverTime = hovered.start * content->duration + span * (frame % 20) / 20.0;
+            return state;
+        }},
+        {"steady/loading", [&](const int frame) {
+            SeekBarState state = loaded;
+            state.loadState = LoadState::Loading;
+            state.loadingProgress = static_cast<double>(frame % 100) / 100.0;
+            return state;
+        }},
+        {"steady/hud", [&](const int frame) {
+            SeekBarState state = loaded;
+            state.cursorTime = frame / 60.0;
+            state.isHudVisible = true;
+            return state;
+        }},
+    }};
+
+    int failedFrames = 0;
+    for (const auto& [name, state] : cases) {
+        if (!filter.empty() && std::string{name}.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        SeekBar bar{surface->getCanvas(), benchWidth, benchHeight};
+        for (int frame = 0; frame < steadyStateWarmupFrames + steadyStateFrames; ++frame) {
+            const SeekBarState frameState = state(frame);
+            uint64_t allocations = 0;
+            {
+                const AllocationScope scope{allocations};
+                bar.applyState(frameState);
+                bar.draw();
+            }
+            if (frame >= steadyStateWarmupFrames && allocations > 0) {
+                std::cerr << name << ": frame " << frame << " made " << allocations << " heap allocation(s)" << std::endl;
+                ++failedFrames;
+            }
+        }
+    }
+    return failedFrames;
+}
+
+void runModelBenchmarks(BenchRunner& runner) {
+    const SeekBarLayout layout{benchWidth, benchHeight};
+
+    for (const size_t count : chapterCounts) {
+        SeekBarModel model = makeLoadedModel(count);
+        runner.run("setHoverForChapter/chapters=" + std::to_string(count), [&](const size_t iteration) {
+            model.setHoverForChapter(sweepX(layout, iteration));
+        });
+        runner.run("updateCursorPosition/chapters=" + std::to_string(count), [&](const size_t iteration) {
+            model.updateCursorPosition(sweepX(layout, iteration));
+        });
+    }
+}
+
+void runUtilityBenchmarks(BenchRunner& runner) {
+    char buffer[timeBufferSize];
+    size_t written = 0;
+    runner.run("formatTime", [&](const size_t iteration) {
+        // Walks through minutes and hours, so both output formats are covered
+        written += formatTime(static_cast<double>(iteration % 10000) * 1.7, buffer, sizeof(buffer)).size();
+    });
+    if (written == 0) {
+        std::cerr << "formatTime wrote nothing" << std::endl;
+    }
+
+    runner.run("ImageProvider/deferred", [](size_t) {
+        const ImageProvider provider{{}, ImageDecodeMode::Deferred};
+    });
+    runner.run("ImageProvider/eager", [](size_t) {
+        const ImageProvider provider{{}, ImageDecodeMode::Eager};
+    });
+}
+
+void writeJson(std::ostream& output, const std::vector<BenchResult>& results) {
+    output << std::fixed << std::setprecision(3) << "{\"benchmarks\":[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& result = results[i];
+        output << "{\"name\":\"" << result.name << "\",\"iterations\":" << result.iterations
+               << ",\"ns_per_op\":" << result.nsPerOp << ",\"min_ns_per_op\":" << result.minNsPerOp
+               << ",\"allocations_per_op\":" << result.allocationsPerOp
+               << ",\"allocated_bytes_per_op\":" << result.allocatedBytesPerOp << "}"
+               << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    output << "]}\n";
+}
+
+void writeCsv(std::ostream& output, const std::vector<BenchResult>& results) {
+    output << std::fixed << std::setprecision(3)
+           << "name,iterations,ns_per_op,min_ns_per_op,allocations_per_op,allocated_bytes_per_op\n";
+    for (const BenchResult& result : results) {
+        output << result.name << ',' << result.iterations << ',' << result.nsPerOp << ',' << result.minNsPerOp << ','
+               << result.allocationsPerOp << ',' << result.allocatedBytesPerOp << '\n';
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    OutputFormat format = OutputFormat::Json;
+    std::string outputPath;
+    std::string filter;
+    double minTime = defaultMinTime;
+    int repetitions = defaultRepetitions;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            const std::string value = argv[++i];
+            if (value != "json" && value != "csv") {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            format = value == "csv" ? OutputFormat::Csv : OutputFormat::Json;
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minTime = std::atof(argv[++i]);
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions = std::atoi(argv[++i]);
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (minTime <= 0.0 || repetitions <= 0) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    BenchRunner runner{minTime, repetitions, filter};
+    try {
+        runDrawBenchmarks(runner);
+        runModelBenchmarks(runner);
+        runUtilityBenchmarks(runner);
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int failedFrames = 0;
+    try {
+        failedFrames = checkSteadyStateFrames(filter);
+    } catch (const std::exception& e) {
+        std::cerr << "Steady-state check failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file) {
+            std::cerr << "Failed to write " << outputPath << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& output = outputPath.empty() ? std::cout : file;
+    if (format == OutputFormat::Csv) {
+        writeCsv(output, runner.results());
+    } else {
+        writeJson(output, runner.results());
+    }
+
+    if (failedFrames > 0) {
+        std::cerr << failedFrames << " steady-state frame(s) allocated" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#include "buffered_ranges.h"
+
+BufferedRanges::BufferedRanges(const size_t queueCapacity)
+    : _updates{queueCapacity}
+    , _droppedUpdates{0} {
+}
+
+void BufferedRanges::add(const double start, const double end) {
+    push({RangeUpdateType::Add, start, end});
+}
+
+void BufferedRanges::remove(const double start, const double end) {
+    push({RangeUpdateType::Remove, start, end});
+}
+
+void BufferedRanges::clear() {
+    push({RangeUpdateType::Clear, 0.0, 0.0});
+}
+
+bool BufferedRanges::drain() {
+    bool isChanged = false;
+    RangeUpdate update;
+
+    // Bounded, so producers pushing faster than we drain cannot stall the frame
+    for (size_t i = 0; i < _updates.capacity() && _updates.tryPop(update); ++i) {
+        switch (update.type) {
+        case RangeUpdateType::Add:
+            isChanged |= _ranges.insert(update.start, update.end);
+            break;
+        case RangeUpdateType::Remove:
+            isChanged |= _ranges.erase(update.start, update.end);
+            break;
+        case RangeUpdateType::Clear:
+            isChanged |= !_ranges.empty();
+            _ranges.clear();
+            break;
+        }
+    }
+    return isChanged;
+}
+
+const IntervalSet& BufferedRanges::ranges() const {
+    return _ranges;
+}
+
+uint64_t BufferedRanges::droppedUpdates() const {
+    return _droppedUpdates.load(std::memory_order_relaxed);
+}
+
+void BufferedRanges::push(const RangeUpdate& update) {
+    if (!_updates.tryPush(update)) {
+        _droppedUpdates.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "interval_set.h"
+#include "mpsc_queue.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class RangeUpdateType {
+    Add,
+    Remove,
+    Clear
+};
+
+struct RangeUpdate {
+    RangeUpdateType type = RangeUpdateType::Clear;
+    double start = 0.0;
+    double end = 0.0;
+};
+
+// Buffered/downloaded time ranges in seconds. Network and decoder threads push updates through a
+// lock-free queue, the render thread applies them once per frame in drain(), so producers never
+// share a lock with drawing and the interval set itself is only touched by the render thread.
+class BufferedRanges {
+public:
+    explicit BufferedRanges(const size_t queueCapacity = 4096);
+
+    // Producer side, any thread. Updates that do not fit into a full queue are dropped and counted.
+    void add(const double start, const double end);
+    void remove(const double start, const double end);
+    void clear();
+
+    // Render thread only; returns true when the ranges changed
+    bool drain();
+    const IntervalSet& ranges() const;
+    uint64_t droppedUpdates() const;
+
+private:
+    void push(const RangeUpdate& update);
+
+    MpscQueue<RangeUpdate> _updates;
+    IntervalSet _ranges;
+    std::atomic<uint64_t> _droppedUpdates;
+};
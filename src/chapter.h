@@ -1,13 +1,24 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 struct Chapter {
     std::string label;
     double start;       // Start position (0.0 to 1.0, relative to seek bar)
     double end;         // End position (0.0 to 1.0, relative to seek bar)
-    double width = 0.0;
-    double height = 15.0;
-    double mouseX = 0.0;
-    bool isHovered = false;
+};
+
+// Per-chapter UI state kept as parallel arrays next to the chapter list, indexed like it
+struct ChapterUiState {
+    std::vector<double> mouseX;
+    std::vector<double> height;
+    std::vector<uint8_t> isHovered;
+
+    void reset(const size_t count, const double defaultHeight) {
+        mouseX.assign(count, 0.0);
+        height.assign(count, defaultHeight);
+        isHovered.assign(count, 0);
+    }
 };
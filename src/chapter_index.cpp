@@ -0,0 +1,56 @@
+#include "chapter_index.h"
+
+#include <algorithm>
+
+void ChapterIndex::rebuild(const std::vector<Chapter>& chapters, const double originX, const double width) {
+    _starts.resize(chapters.size());
+    _ends.resize(chapters.size());
+    _startXs.resize(chapters.size());
+    _endXs.resize(chapters.size());
+
+    for (size_t i = 0; i < chapters.size(); ++i) {
+        _starts[i] = chapters[i].start;
+        _ends[i] = chapters[i].end;
+        _startXs[i] = originX + width * chapters[i].start;
+        _endXs[i] = originX + width * chapters[i].end;
+    }
+}
+
+std::optional<size_t> ChapterIndex::findByX(const double x) const {
+    // Last chapter starting at or before x, then check that x did not fall into a gap after it
+    const auto it = std::upper_bound(_startXs.begin(), _startXs.end(), x);
+    if (it == _startXs.begin()) {
+        return std::nullopt;
+    }
+
+    const size_t index = static_cast<size_t>(std::distance(_startXs.begin(), it)) - 1;
+    if (x > _endXs[index]) {
+        return std::nullopt;
+    }
+    return index;
+}
+
+std::optional<size_t> ChapterIndex::findByPosition(const double position) const {
+    const auto it = std::upper_bound(_starts.begin(), _starts.end(), position);
+    if (it == _starts.begin()) {
+        return std::nullopt;
+    }
+
+    const size_t index = static_cast<size_t>(std::distance(_starts.begin(), it)) - 1;
+    if (position > _ends[index]) {
+        return std::nullopt;
+    }
+    return index;
+}
+
+double ChapterIndex::startX(const size_t index) const {
+    return _startXs[index];
+}
+
+double ChapterIndex::endX(const size_t index) const {
+    return _endXs[index];
+}
+
+size_t ChapterIndex::size() const {
+    return _startXs.size();
+}
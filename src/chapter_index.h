@@ -0,0 +1,26 @@
+#pragma once
+
+#include "chapter.h"
+
+#include <optional>
+#include <vector>
+
+// Sorted lookup structure over chapters with pixel bounds cached per layout.
+// Chapters are expected to be sorted by start and not to overlap.
+class ChapterIndex {
+public:
+    void rebuild(const std::vector<Chapter>& chapters, const double originX, const double width);
+
+    std::optional<size_t> findByX(const double x) const;
+    std::optional<size_t> findByPosition(const double position) const; // Relative position (0.0 to 1.0)
+
+    double startX(const size_t index) const;
+    double endX(const size_t index) const;
+    size_t size() const;
+
+private:
+    std::vector<double> _starts;
+    std::vector<double> _ends;
+    std::vector<double> _startXs;
+    std::vector<double> _endXs;
+};
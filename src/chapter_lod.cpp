@@ -0,0 +1,47 @@
+#include "chapter_lod.h"
+
+#include <algorithm>
+
+constexpr double maxMergedGap = 0.5; // Gaps narrower than half a pixel are invisible
+
+void ChapterLod::rebuild(const ChapterIndex& index, const ChapterUiState& uiState, const double minMarkerSpacing) {
+    _spans.clear();
+    _markers.clear();
+
+    const size_t count = index.size();
+    if (count == 0) {
+        return;
+    }
+
+    double lastMarkerX = 0.0;
+    const auto addMarker = [&](const double x, const double height) {
+        // Keep markers of taller chapters even when crowded, the rest only when distinct
+        if (_markers.empty() || x - lastMarkerX >= minMarkerSpacing || height > _markers.back().height) {
+            _markers.push_back({x, height});
+            lastMarkerX = x;
+        }
+    };
+
+    for (size_t i = 0; i < count; ++i) {
+        const double startX = index.startX(i);
+        const double endX = index.endX(i);
+        const double height = uiState.height[i];
+
+        if (!_spans.empty() && _spans.back().height == height && startX - _spans.back().endX < maxMergedGap) {
+            _spans.back().endX = std::max(_spans.back().endX, endX);
+        } else {
+            _spans.push_back({startX, endX, height});
+        }
+
+        // First chapter has its marker at the end, every other one at the start
+        addMarker(i == 0 ? endX : startX, height);
+    }
+}
+
+const std::vector<ChapterSpan>& ChapterLod::spans() const {
+    return _spans;
+}
+
+const std::vector<ChapterMarker>& ChapterLod::markers() const {
+    return _markers;
+}
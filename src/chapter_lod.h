@@ -0,0 +1,33 @@
+#pragma once
+
+#include "chapter.h"
+#include "chapter_index.h"
+
+#include <vector>
+
+// Run of adjacent chapters drawn as a single rect
+struct ChapterSpan {
+    double startX;
+    double endX;
+    double height;
+};
+
+struct ChapterMarker {
+    double x;
+    double height;
+};
+
+// Level-of-detail view of the chapter list for drawing. Contiguous chapters of equal height are merged
+// into spans and markers closer than the minimum spacing to the previous one are dropped, so the
+// number of draw calls is bounded by the bar width rather than by the chapter count.
+class ChapterLod {
+public:
+    void rebuild(const ChapterIndex& index, const ChapterUiState& uiState, const double minMarkerSpacing);
+
+    const std::vector<ChapterSpan>& spans() const;
+    const std::vector<ChapterMarker>& markers() const;
+
+private:
+    std::vector<ChapterSpan> _spans;
+    std::vector<ChapterMarker> _markers;
+};
@@ -0,0 +1,41 @@
+#include "clock.h"
+
+#include <chrono>
+
+namespace {
+
+double steadySeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+const Clock& Clock::steady() {
+    static const SteadyClock clock;
+    return clock;
+}
+
+SteadyClock::SteadyClock()
+    : _origin{steadySeconds()} {
+}
+
+double SteadyClock::now() const {
+    return steadySeconds() - _origin;
+}
+
+ManualClock::ManualClock(const double start)
+    : _time{start} {
+}
+
+double ManualClock::now() const {
+    return _time.load(std::memory_order_relaxed);
+}
+
+void ManualClock::set(const double time) {
+    _time.store(time, std::memory_order_relaxed);
+}
+
+void ManualClock::advance(const double seconds) {
+    // Single writer, so load + store is enough
+    _time.store(_time.load(std::memory_order_relaxed) + seconds, std::memory_order_relaxed);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+
+// Time source for everything in the seek bar that depends on time. Normal runs use the steady clock;
+// input replays use a ManualClock set to the recorded timestamps, so the same session behaves the
+// same way no matter how fast frames are drawn. Times are in seconds.
+class Clock {
+public:
+    virtual ~Clock() = default;
+    virtual double now() const = 0;
+
+    static const Clock& steady();
+};
+
+// Seconds since the clock was created
+class SteadyClock : public Clock {
+public:
+    SteadyClock();
+    double now() const override;
+
+private:
+    double _origin;
+};
+
+// Only moves when told to; safe to read from another thread while it is being set
+class ManualClock : public Clock {
+public:
+    explicit ManualClock(const double start = 0.0);
+    double now() const override;
+
+    void set(const double time);
+    void advance(const double seconds);
+
+private:
+    std::atomic<double> _time;
+};
@@ -0,0 +1,125 @@
+#include "color_convert.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// BT.601 limited range in 8.8 fixed point, the usual integer approximation encoders use
+inline uint8_t lumaOf(const int r, const int g, const int b) {
+    return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+}
+
+inline uint8_t chromaUOf(const int r, const int g, const int b) {
+    return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+}
+
+inline uint8_t chromaVOf(const int r, const int g, const int b) {
+    return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+}
+
+#if defined(__SSE2__)
+
+// Splits 8 RGBA pixels into 16-bit R, G and B lanes
+inline void unpackRgb(const uint8_t* pixels, __m128i& r, __m128i& g, __m128i& b) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + 16));
+    r = _mm_packs_epi32(_mm_and_si128(low, mask), _mm_and_si128(high, mask));
+    g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(low, 8), mask), _mm_and_si128(_mm_srli_epi32(high, 8), mask));
+    b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(low, 16), mask), _mm_and_si128(_mm_srli_epi32(high, 16), mask));
+}
+
+// The weighted sum stays below 65536, so unsigned 16-bit lanes and a logical shift are exact
+inline __m128i luma(const __m128i r, const __m128i g, const __m128i b) {
+    __m128i sum = _mm_mullo_epi16(r, _mm_set1_epi16(66));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(25)));
+    sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+    return _mm_add_epi16(_mm_srli_epi16(sum, 8), _mm_set1_epi16(16));
+}
+
+// Sums of horizontal pixel pairs of both rows, averaged: 8 pixels per row become 4 lanes
+inline __m128i average2x2(const __m128i top, const __m128i bottom) {
+    return _mm_madd_epi16(_mm_add_epi16(top, bottom), _mm_set1_epi16(1));
+}
+
+// Each partial sum stays within +-28688, signed 16-bit lanes are exact
+inline __m128i chroma(const __m128i r, const __m128i g, const __m128i b, const int cr, const int cg, const int cb) {
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(static_cast<int16_t>(cb))), _mm_set1_epi16(128));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(r, _mm_set1_epi16(static_cast<int16_t>(cr))));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(g, _mm_set1_epi16(static_cast<int16_t>(cg))));
+    return _mm_add_epi16(_mm_srai_epi16(sum, 8), _mm_set1_epi16(128));
+}
+
+// 16 pixels of two rows: 32 luma samples and 8 samples of each chroma plane
+inline void convertBlock(const uint8_t* top, const uint8_t* bottom, uint8_t* yTop, uint8_t* yBottom, uint8_t* u, uint8_t* v) {
+    __m128i r[4], g[4], b[4];
+    unpackRgb(top, r[0], g[0], b[0]);
+    unpackRgb(top + 32, r[1], g[1], b[1]);
+    unpackRgb(bottom, r[2], g[2], b[2]);
+    unpackRgb(bottom + 32, r[3], g[3], b[3]);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(yTop),
+        _mm_packus_epi16(luma(r[0], g[0], b[0]), luma(r[1], g[1], b[1])));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(yBottom),
+        _mm_packus_epi16(luma(r[2], g[2], b[2]), luma(r[3], g[3], b[3])));
+
+    const __m128i rounding = _mm_set1_epi16(2);
+    const auto average = [&](const __m128i* channel) {
+        const __m128i sums = _mm_packs_epi32(average2x2(channel[0], channel[2]), average2x2(channel[1], channel[3]));
+        return _mm_srli_epi16(_mm_add_epi16(sums, rounding), 2);
+    };
+    const __m128i rAverage = average(r);
+    const __m128i gAverage = average(g);
+    const __m128i bAverage = average(b);
+
+    const __m128i zero = _mm_setzero_si128();
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(u),
+        _mm_packus_epi16(chroma(rAverage, gAverage, bAverage, -38, -74, 112), zero));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(v),
+        _mm_packus_epi16(chroma(rAverage, gAverage, bAverage, 112, -94, -18), zero));
+}
+
+#endif
+
+} // namespace
+
+void convertRgbaToI420(const uint8_t* rgba, const size_t rowBytes, const int width, const int height, const I420Planes& planes) {
+    for (int row = 0; row < height; row += 2) {
+        const uint8_t* top = rgba + row * rowBytes;
+        // The last row of an odd height pairs with itself
+        const int bottomRow = row + 1 < height ? row + 1 : row;
+        const uint8_t* bottom = rgba + bottomRow * rowBytes;
+        uint8_t* yTop = planes.y + row * planes.yStride;
+        uint8_t* yBottom = planes.y + bottomRow * planes.yStride;
+        uint8_t* u = planes.u + (row / 2) * planes.uvStride;
+        uint8_t* v = planes.v + (row / 2) * planes.uvStride;
+        int x = 0;
+
+#if defined(__SSE2__)
+        for (; x + 16 <= width; x += 16) {
+            convertBlock(top + x * 4, bottom + x * 4, yTop + x, yBottom + x, u + x / 2, v + x / 2);
+        }
+#endif
+
+        for (; x < width; x += 2) {
+            const int right = x + 1 < width ? x + 1 : x;
+            const uint8_t* pixels[4] = {top + x * 4, top + right * 4, bottom + x * 4, bottom + right * 4};
+
+            yTop[x] = lumaOf(pixels[0][0], pixels[0][1], pixels[0][2]);
+            yBottom[x] = lumaOf(pixels[2][0], pixels[2][1], pixels[2][2]);
+            if (right != x) {
+                yTop[right] = lumaOf(pixels[1][0], pixels[1][1], pixels[1][2]);
+                yBottom[right] = lumaOf(pixels[3][0], pixels[3][1], pixels[3][2]);
+            }
+
+            const int r = (pixels[0][0] + pixels[1][0] + pixels[2][0] + pixels[3][0] + 2) >> 2;
+            const int g = (pixels[0][1] + pixels[1][1] + pixels[2][1] + pixels[3][1] + 2) >> 2;
+            const int b = (pixels[0][2] + pixels[1][2] + pixels[2][2] + pixels[3][2] + 2) >> 2;
+            u[x / 2] = chromaUOf(r, g, b);
+            v[x / 2] = chromaVOf(r, g, b);
+        }
+    }
+}
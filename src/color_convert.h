@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Destination planes of an I420 (YUV 4:2:0) frame. Chroma planes are (width + 1) / 2 by (height + 1) / 2.
+struct I420Planes {
+    uint8_t* y;
+    uint8_t* u;
+    uint8_t* v;
+    size_t yStride;
+    size_t uvStride;
+};
+
+// Converts 8-bit RGBA (R in the lowest byte, alpha ignored) to limited range BT.601 I420. Chroma is the
+// average of each 2x2 block; odd edges reuse the last row/column.
+void convertRgbaToI420(const uint8_t* rgba, const size_t rowBytes, const int width, const int height, const I420Planes& planes);
@@ -0,0 +1,40 @@
+#include "embedded_assets.h"
+
+#include "include/core/SkData.h"
+
+#ifdef SEEKBAR_EMBED_ASSETS
+// Defined in the source generated by cmake/embed_assets.cmake
+extern const EmbeddedAsset embeddedAssets[];
+extern const size_t embeddedAssetCount;
+#endif
+
+namespace {
+
+const EmbeddedAsset* findEmbeddedAsset([[maybe_unused]] std::string_view name) {
+#ifdef SEEKBAR_EMBED_ASSETS
+    for (size_t i = 0; i < embeddedAssetCount; ++i) {
+        if (name == embeddedAssets[i].name) {
+            return &embeddedAssets[i];
+        }
+    }
+#endif
+    return nullptr;
+}
+
+} // namespace
+
+const std::filesystem::path& assetDirectory() {
+    // Binaries are run from the build directory, assets live next to it in the repository root
+    static const std::filesystem::path directory = std::filesystem::absolute(std::filesystem::current_path().parent_path());
+    return directory;
+}
+
+sk_sp<SkData> loadAsset(std::string_view name, const std::filesystem::path& assetRoot) {
+    if (const EmbeddedAsset* asset = findEmbeddedAsset(name)) {
+        // Arrays live in the binary for the whole run, so SkData can point at them directly
+        return SkData::MakeWithoutCopy(asset->data, asset->size);
+    }
+    // The working directory is only looked at when the asset has to come from disk
+    const std::filesystem::path& root = assetRoot.empty() ? assetDirectory() : assetRoot;
+    return SkData::MakeFromFileName((root / name).c_str());
+}
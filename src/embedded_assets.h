@@ -0,0 +1,23 @@
+#pragma once
+
+#include "include/core/SkRefCnt.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+class SkData;
+
+struct EmbeddedAsset {
+    const char* name;   // Path relative to the repository root, e.g. "icons/play.png"
+    const unsigned char* data;
+    size_t size;
+};
+
+// Directory the on-disk assets are loaded from when they are not compiled in, resolved on first use
+const std::filesystem::path& assetDirectory();
+
+// Returns the asset compiled into the binary (SEEKBAR_EMBED_ASSETS build option) without copying it,
+// or falls back to reading (assetRoot / name) from disk. An empty assetRoot means assetDirectory().
+// Null when neither is available.
+sk_sp<SkData> loadAsset(std::string_view name, const std::filesystem::path& assetRoot = {});
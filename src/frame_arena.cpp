@@ -0,0 +1,54 @@
+#include "frame_arena.h"
+
+FrameArena::FrameArena(const size_t initialCapacity)
+    : _block{initialCapacity > 0 ? std::make_unique<std::byte[]>(initialCapacity) : nullptr}
+    , _capacity{initialCapacity}
+    , _used{0}
+    , _requested{0} {
+}
+
+void FrameArena::reset() {
+    if (_requested > _capacity) {
+        // Headroom for padding, so a repeat of the same frame fits without spilling
+        _capacity = _requested + _requested / 4;
+        _block = std::make_unique<std::byte[]>(_capacity);
+    }
+    _spills.clear();
+    _used = 0;
+    _requested = 0;
+}
+
+size_t FrameArena::capacity() const {
+    return _capacity;
+}
+
+size_t FrameArena::used() const {
+    return _used;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+    _requested += bytes + alignment;
+
+    if (_block) {
+        void* pointer = _block.get() + _used;
+        size_t space = _capacity - _used;
+        if (std::align(alignment, bytes, pointer, space)) {
+            _used = _capacity - space + bytes;
+            return pointer;
+        }
+    }
+
+    auto spill = std::make_unique<std::byte[]>(bytes + alignment);
+    void* pointer = spill.get();
+    size_t space = bytes + alignment;
+    std::align(alignment, bytes, pointer, space);
+    _spills.push_back(std::move(spill));
+    return pointer;
+}
+
+void FrameArena::do_deallocate(void*, size_t, size_t) {
+}
+
+bool FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
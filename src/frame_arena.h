@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Bump allocator for data that only lives until the end of a frame. Deallocation is a no-op, reset()
+// at frame start rewinds it. A frame that needs more than the block spills to the heap and the
+// block grows to that frame's peak on the next reset, so steady-state frames never allocate.
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(const size_t initialCapacity = 0);
+
+    void reset();
+
+    size_t capacity() const;
+    size_t used() const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    std::unique_ptr<std::byte[]> _block;
+    size_t _capacity;
+    size_t _used;
+    size_t _requested; // Bytes asked for this frame, spilled ones included
+    std::vector<std::unique_ptr<std::byte[]>> _spills;
+};
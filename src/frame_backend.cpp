@@ -0,0 +1,196 @@
+#define SK_GANESH
+#define SK_GL
+
+#include "frame_backend.h"
+#include "frame_profiler.h"
+
+#include "GLFW/glfw3.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkSurface.h"
+#include "include/gpu/ganesh/GrBackendSurface.h"
+#include "include/gpu/ganesh/GrDirectContext.h"
+#include "include/gpu/ganesh/SkSurfaceGanesh.h"
+#include "include/gpu/ganesh/gl/GrGLAssembleInterface.h"
+#include "include/gpu/ganesh/gl/GrGLBackendSurface.h"
+#include "include/gpu/ganesh/gl/GrGLDirectContext.h"
+#include "include/gpu/ganesh/gl/GrGLInterface.h"
+#include "include/gpu/ganesh/gl/GrGLTypes.h"
+
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+GLuint createFrameTexture(const int width, const int height) {
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    return texture;
+}
+
+void uploadDamage(const sk_sp<SkSurface>& surface, const SkIRect& damage) {
+    SkPixmap pixmap;
+
+    if (damage.isEmpty() || !surface->peekPixels(&pixmap)) {
+        return;
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(pixmap.rowBytes() / pixmap.info().bytesPerPixel()));
+    glTexSubImage2D(
+        GL_TEXTURE_2D, 0,
+        damage.x(), damage.y(), damage.width(), damage.height(),
+        GL_RGBA, GL_UNSIGNED_BYTE,
+        pixmap.addr(damage.x(), damage.y()));
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+// The framebuffer covers the bottom-left u x v part of the power-of-two texture
+void drawFrameTexture(const float u, const float v) {
+    // Texture row 0 lands at the bottom of the window, same as glDrawPixels
+    glEnable(GL_TEXTURE_2D);
+    glBegin(GL_QUADS);
+    glTexCoord2f(0.0f, 0.0f); glVertex2f(-1.0f, -1.0f);
+    glTexCoord2f(u, 0.0f); glVertex2f(1.0f, -1.0f);
+    glTexCoord2f(u, v); glVertex2f(1.0f, 1.0f);
+    glTexCoord2f(0.0f, v); glVertex2f(-1.0f, 1.0f);
+    glEnd();
+    glDisable(GL_TEXTURE_2D);
+}
+
+} // namespace
+
+std::unique_ptr<FrameBackend> createFrameBackend(const RenderBackend backend) {
+    if (backend == RenderBackend::Gpu) {
+        try {
+            return std::make_unique<GaneshFrameBackend>();
+        } catch (const std::exception& e) {
+            std::cerr << "GPU backend unavailable, falling back to raster: " << e.what() << std::endl;
+        }
+    }
+    return std::make_unique<RasterFrameBackend>();
+}
+
+RasterFrameBackend::RasterFrameBackend()
+    : _texture{0}
+    , _framebufferWidth{0}
+    , _framebufferHeight{0} {
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glEnable(GL_BLEND);
+    glEnable(GL_FRAMEBUFFER_SRGB);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+RasterFrameBackend::~RasterFrameBackend() {
+    glDeleteTextures(1, &_texture);
+}
+
+std::string_view RasterFrameBackend::name() const {
+    return "raster";
+}
+
+SkCanvas* RasterFrameBackend::resize(const int framebufferWidth, const int framebufferHeight, const float scale) {
+    _framebufferWidth = framebufferWidth;
+    _framebufferHeight = framebufferHeight;
+
+    // Surface and texture only change when the size crosses a power of two
+    auto surface = _surfaces.acquire(framebufferWidth, framebufferHeight);
+    if (surface != _surface) {
+        glDeleteTextures(1, &_texture);
+        _texture = createFrameTexture(surface->width(), surface->height());
+        _surface = std::move(surface);
+    }
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+
+    // GL textures store rows bottom-up, so flip the canvas to keep the seek bar coordinates top-down
+    SkCanvas* canvas = _surface->getCanvas();
+    canvas->restoreToCount(1);
+    canvas->resetMatrix();
+    canvas->scale(1, -1);
+    canvas->translate(0, -framebufferHeight);
+    canvas->scale(scale, scale);
+    return canvas;
+}
+
+bool RasterFrameBackend::keepsFrameContents() const {
+    // The back buffer is redrawn from the persistent texture every frame
+    return true;
+}
+
+void RasterFrameBackend::beginFrame() {
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void RasterFrameBackend::endFrame(const SkIRect& damage) {
+    SEEKBAR_PROFILE_SCOPE("frame.upload");
+    // Only the damaged rows/columns go to the persistent texture, the back buffer is redrawn from it
+    uploadDamage(_surface, damage);
+    drawFrameTexture(
+        static_cast<float>(_framebufferWidth) / _surface->width(),
+        static_cast<float>(_framebufferHeight) / _surface->height());
+}
+
+GaneshFrameBackend::GaneshFrameBackend()
+    // Resolved through GLFW so it works with whatever GL the window got, including Mesa's llvmpipe
+    : _interface{GrGLMakeAssembledInterface(nullptr, [](void*, const char name[]) -> GrGLFuncPtr {
+        return glfwGetProcAddress(name);
+    })}
+    , _sampleCount{0}
+    , _stencilBits{0} {
+    if (!_interface) {
+        throw std::runtime_error("Failed to assemble the GL interface");
+    }
+    _context = GrDirectContexts::MakeGL(_interface);
+    if (!_context) {
+        throw std::runtime_error("Failed to create the Ganesh GL context");
+    }
+
+    glGetIntegerv(GL_SAMPLES, &_sampleCount);
+    glGetIntegerv(GL_STENCIL_BITS, &_stencilBits);
+}
+
+GaneshFrameBackend::~GaneshFrameBackend() {
+    // The surface holds on to the context, release it first while the GL context is still current
+    _surface.reset();
+    _context.reset();
+}
+
+std::string_view GaneshFrameBackend::name() const {
+    return "gpu";
+}
+
+SkCanvas* GaneshFrameBackend::resize(const int framebufferWidth, const int framebufferHeight, const float scale) {
+    GrGLFramebufferInfo framebufferInfo;
+    framebufferInfo.fFBOID = 0;
+    framebufferInfo.fFormat = GL_RGBA8;
+
+    // Wrapping the default framebuffer allocates nothing, so it is simply rewrapped at the new size
+    const GrBackendRenderTarget target =
+        GrBackendRenderTargets::MakeGL(framebufferWidth, framebufferHeight, _sampleCount, _stencilBits, framebufferInfo);
+    _surface = SkSurfaces::WrapBackendRenderTarget(
+        _context.get(), target, kBottomLeft_GrSurfaceOrigin, kRGBA_8888_SkColorType, nullptr, nullptr);
+    if (!_surface) {
+        throw std::runtime_error("Failed to wrap the window framebuffer");
+    }
+
+    // Skia flips bottom-left origin targets itself, only logical units need scaling
+    SkCanvas* canvas = _surface->getCanvas();
+    canvas->scale(scale, scale);
+    return canvas;
+}
+
+bool GaneshFrameBackend::keepsFrameContents() const {
+    return false;
+}
+
+void GaneshFrameBackend::beginFrame() {
+}
+
+void GaneshFrameBackend::endFrame([[maybe_unused]] const SkIRect& damage) {
+    SEEKBAR_PROFILE_SCOPE("frame.flush");
+    _context->flushAndSubmit();
+}
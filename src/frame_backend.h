@@ -0,0 +1,79 @@
+#pragma once
+
+#include "surface_pool.h"
+
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+#include <memory>
+#include <string_view>
+
+class GrDirectContext;
+class SkCanvas;
+class SkSurface;
+struct GrGLInterface;
+
+enum class RenderBackend {
+    Raster, // CPU rasterization, damaged pixels uploaded to a texture
+    Gpu     // Skia Ganesh drawing straight into the window framebuffer
+};
+
+// Where seek bar frames are drawn and how they reach the window. Created, used and destroyed on the
+// thread that has the GL context current.
+class FrameBackend {
+public:
+    virtual ~FrameBackend() = default;
+
+    virtual std::string_view name() const = 0;
+
+    // Framebuffer size in pixels, scale maps logical units to pixels. Returns the canvas to draw into,
+    // already transformed so the seek bar can draw in logical, top-down coordinates.
+    virtual SkCanvas* resize(const int framebufferWidth, const int framebufferHeight, const float scale) = 0;
+
+    // False when the window contents are lost on swap and every frame has to be drawn in full
+    virtual bool keepsFrameContents() const = 0;
+
+    virtual void beginFrame() = 0;
+    virtual void endFrame(const SkIRect& damage) = 0; // Damage in device pixels
+};
+
+// Falls back to raster when the GPU backend cannot be created
+std::unique_ptr<FrameBackend> createFrameBackend(const RenderBackend backend);
+
+class RasterFrameBackend : public FrameBackend {
+public:
+    RasterFrameBackend();
+    ~RasterFrameBackend() override;
+
+    std::string_view name() const override;
+    SkCanvas* resize(const int framebufferWidth, const int framebufferHeight, const float scale) override;
+    bool keepsFrameContents() const override;
+    void beginFrame() override;
+    void endFrame(const SkIRect& damage) override;
+
+private:
+    SurfacePool _surfaces;
+    sk_sp<SkSurface> _surface; // Power-of-two sized, the framebuffer covers its top-left corner
+    unsigned int _texture;
+    int _framebufferWidth;
+    int _framebufferHeight;
+};
+
+class GaneshFrameBackend : public FrameBackend {
+public:
+    GaneshFrameBackend();
+    ~GaneshFrameBackend() override;
+
+    std::string_view name() const override;
+    SkCanvas* resize(const int framebufferWidth, const int framebufferHeight, const float scale) override;
+    bool keepsFrameContents() const override;
+    void beginFrame() override;
+    void endFrame(const SkIRect& damage) override;
+
+private:
+    sk_sp<const GrGLInterface> _interface;
+    sk_sp<GrDirectContext> _context;
+    sk_sp<SkSurface> _surface; // Wraps the default framebuffer, no pixels of its own
+    int _sampleCount;
+    int _stencilBits;
+};
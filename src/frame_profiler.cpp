@@ -0,0 +1,141 @@
+#include "frame_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <utility>
+
+constexpr size_t maxPhases = 64; // Distinct phase names expected, more only grow the result
+
+namespace {
+
+uint32_t currentThreadId() {
+    static std::atomic<uint32_t> nextThreadId{1};
+    thread_local const uint32_t threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return threadId;
+}
+
+using NamedDuration = std::pair<std::string_view, uint64_t>;
+
+// Samples of one phase, sorted by duration
+double percentile(const NamedDuration* sortedSamples, const size_t count, const double fraction) {
+    const size_t rank = static_cast<size_t>(std::ceil(fraction * count));
+    const size_t index = std::clamp<size_t>(rank, 1, count) - 1;
+    return sortedSamples[index].second / 1e6;
+}
+
+} // namespace
+
+FrameProfiler& FrameProfiler::instance() {
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+FrameProfiler::FrameProfiler()
+    : _slots{std::make_unique<Slot[]>(capacity)}
+    , _next{0} {
+}
+
+uint64_t FrameProfiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void FrameProfiler::record(const char* name, const uint64_t startNanoseconds, const uint64_t durationNanoseconds) {
+    const uint64_t index = _next.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = _slots[index % capacity];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.startNanoseconds.store(startNanoseconds, std::memory_order_relaxed);
+    slot.durationNanoseconds.store(durationNanoseconds, std::memory_order_relaxed);
+    slot.threadId.store(currentThreadId(), std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+template <typename Visitor>
+void FrameProfiler::forEachEvent(Visitor&& visit) const {
+    const uint64_t end = _next.load(std::memory_order_acquire);
+    const uint64_t begin = end > capacity ? end - capacity : 0;
+
+    for (uint64_t index = begin; index < end; ++index) {
+        const Slot& slot = _slots[index % capacity];
+
+        // Skip slots still being written or already overwritten by a newer event
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+            continue;
+        }
+        ProfileEvent event;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.startNanoseconds = slot.startNanoseconds.load(std::memory_order_relaxed);
+        event.durationNanoseconds = slot.durationNanoseconds.load(std::memory_order_relaxed);
+        event.threadId = slot.threadId.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == index + 1) {
+            visit(event);
+        }
+    }
+}
+
+std::vector<ProfileEvent> FrameProfiler::events() const {
+    std::vector<ProfileEvent> events;
+    events.reserve(capacity);
+    forEachEvent([&](const ProfileEvent& event) {
+        events.push_back(event);
+    });
+    return events;
+}
+
+std::pmr::vector<ProfilePhaseStats> FrameProfiler::stats(std::pmr::memory_resource* resource) const {
+    // Sorting (name, duration) pairs groups the phases and orders each phase's durations in one pass;
+    // reserving the whole ring keeps the scratch size the same from call to call
+    std::pmr::vector<NamedDuration> samples{resource};
+    samples.reserve(capacity);
+    forEachEvent([&](const ProfileEvent& event) {
+        samples.emplace_back(event.name, event.durationNanoseconds);
+    });
+    std::sort(samples.begin(), samples.end());
+
+    std::pmr::vector<ProfilePhaseStats> stats{resource};
+    stats.reserve(maxPhases);
+    for (size_t begin = 0; begin < samples.size();) {
+        size_t end = begin + 1;
+        while (end < samples.size() && samples[end].first == samples[begin].first) {
+            ++end;
+        }
+        const size_t count = end - begin;
+        stats.push_back({
+            samples[begin].first,
+            count,
+            percentile(&samples[begin], count, 0.50),
+            percentile(&samples[begin], count, 0.95),
+            percentile(&samples[begin], count, 0.99)});
+        begin = end;
+    }
+    return stats;
+}
+
+bool FrameProfiler::writeChromeTrace(const std::filesystem::path& outputPath) const {
+    std::ofstream file{outputPath};
+    if (!file) {
+        return false;
+    }
+
+    // Trace Event Format, complete ("X") events with microsecond timestamps; names are plain literals
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char* separator = "\n";
+    for (const auto& event : events()) {
+        file << separator
+             << "{\"name\":\"" << event.name << "\",\"cat\":\"seekbar\",\"ph\":\"X\""
+             << ",\"ts\":" << event.startNanoseconds / 1000.0
+             << ",\"dur\":" << event.durationNanoseconds / 1000.0
+             << ",\"pid\":1,\"tid\":" << event.threadId << "}";
+        separator = ",\n";
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
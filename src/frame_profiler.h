@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+struct ProfileEvent {
+    const char* name = nullptr; // String literal, compared by content when grouping
+    uint64_t startNanoseconds = 0;
+    uint64_t durationNanoseconds = 0;
+    uint32_t threadId = 0;
+};
+
+struct ProfilePhaseStats {
+    std::string_view name;
+    size_t count = 0;
+    double p50 = 0.0; // Milliseconds
+    double p95 = 0.0;
+    double p99 = 0.0;
+};
+
+// Keeps the most recent timed scopes from any thread in a fixed ring buffer. Recording is lock-free and
+// never allocates; older events are overwritten. Readers take a consistent copy of whatever is in the
+// ring, so stats and trace export can run on another thread while frames are being recorded.
+class FrameProfiler {
+public:
+    static constexpr size_t capacity = 1 << 14;
+
+    static FrameProfiler& instance();
+    static uint64_t now(); // Nanoseconds on the steady clock
+
+    void record(const char* name, const uint64_t startNanoseconds, const uint64_t durationNanoseconds);
+
+    std::vector<ProfileEvent> events() const; // Oldest first
+    // Sorted by name. Scratch space and the result come from resource, so with a frame arena the
+    // HUD can refresh without touching the heap.
+    std::pmr::vector<ProfilePhaseStats> stats(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+    bool writeChromeTrace(const std::filesystem::path& outputPath) const;
+
+private:
+    FrameProfiler();
+
+    template <typename Visitor>
+    void forEachEvent(Visitor&& visit) const;
+
+    // Seqlock per slot: sequence is 0 while the slot is being written, otherwise ring index + 1
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> startNanoseconds{0};
+        std::atomic<uint64_t> durationNanoseconds{0};
+        std::atomic<uint32_t> threadId{0};
+    };
+
+    std::unique_ptr<Slot[]> _slots;
+    std::atomic<uint64_t> _next;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : _name{name}
+        , _start{FrameProfiler::now()} {
+    }
+
+    ~ProfileScope() {
+        FrameProfiler::instance().record(_name, _start, FrameProfiler::now() - _start);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* _name;
+    uint64_t _start;
+};
+
+// Times the rest of the enclosing block; expands to nothing unless built with SEEKBAR_PROFILING
+#define SEEKBAR_PROFILE_CONCAT_INNER(a, b) a##b
+#define SEEKBAR_PROFILE_CONCAT(a, b) SEEKBAR_PROFILE_CONCAT_INNER(a, b)
+#ifdef SEEKBAR_PROFILING
+#define SEEKBAR_PROFILE_SCOPE(name) const ProfileScope SEEKBAR_PROFILE_CONCAT(profileScope, __LINE__){name}
+#else
+#define SEEKBAR_PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,166 @@
+#include "headless_renderer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+
+constexpr int defaultWidth = 960;
+constexpr int defaultHeight = 640;
+
+namespace {
+
+struct BatchEntry {
+    std::filesystem::path output;
+    SeekBarState state;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--width W] [--height H] [--compression 0-9] <batch_file|->\n"
+              << "\n"
+              << "Every non-empty line of the batch file (lines starting with '#' are skipped) describes one image:\n"
+              << "  <output.png> [time=<seconds>] [hover=<chapter>] [state=none|loading|loaded]\n"
+              << "               [loading=<0.0-1.0>] [playing=0|1] [muted=0|1] [cursor=0|1]\n";
+}
+
+bool parseBool(const std::string& value) {
+    return value == "1" || value == "true" || value == "yes";
+}
+
+std::optional<BatchEntry> parseLine(const std::string& line) {
+    std::istringstream stream{line};
+    BatchEntry entry;
+
+    std::string token;
+    if (!(stream >> token) || token.front() == '#') {
+        return std::nullopt;
+    }
+    entry.output = token;
+
+    while (stream >> token) {
+        const auto separator = token.find('=');
+        if (separator == std::string::npos) {
+            throw std::runtime_error("Expected key=value, got '" + token + "'");
+        }
+        const std::string key = token.substr(0, separator);
+        const std::string value = token.substr(separator + 1);
+
+        if (key == "time") {
+            entry.state.cursorTime = std::stod(value);
+        } else if (key == "hover") {
+            entry.state.hoveredChapter = std::stoi(value);
+        } else if (key == "state") {
+            if (value == "none") {
+                entry.state.loadState = LoadState::None;
+            } else if (value == "loading") {
+                entry.state.loadState = LoadState::Loading;
+            } else if (value == "loaded") {
+                entry.state.loadState = LoadState::Loaded;
+            } else {
+                throw std::runtime_error("Unknown state '" + value + "'");
+            }
+        } else if (key == "loading") {
+            entry.state.loadingProgress = std::stod(value);
+        } else if (key == "playing") {
+            entry.state.isPlaying = parseBool(value);
+        } else if (key == "muted") {
+            entry.state.isMuted = parseBool(value);
+        } else if (key == "cursor") {
+            entry.state.isCursorVisible = parseBool(value);
+        } else {
+            throw std::runtime_error("Unknown key '" + key + "'");
+        }
+    }
+
+    return entry;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int width = defaultWidth;
+    int height = defaultHeight;
+    std::optional<int> compression;
+    std::string batchPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--width" && i + 1 < argc) {
+            width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            height = std::atoi(argv[++i]);
+        } else if (arg == "--compression" && i + 1 < argc) {
+            compression = std::atoi(argv[++i]);
+        } else if (batchPath.empty()) {
+            batchPath = arg;
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (batchPath.empty() || width <= 0 || height <= 0) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file;
+    if (batchPath != "-") {
+        file.open(batchPath);
+        if (!file) {
+            std::cerr << "Failed to open batch file: " << batchPath << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    std::istream& input = batchPath == "-" ? std::cin : file;
+
+    try {
+        HeadlessRenderer renderer{width, height};
+        if (compression) {
+            renderer.setPngCompressionLevel(*compression);
+        }
+
+        size_t rendered = 0;
+        size_t failed = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+        std::string line;
+        size_t lineNumber = 0;
+        while (std::getline(input, line)) {
+            ++lineNumber;
+            std::optional<BatchEntry> entry;
+            try {
+                entry = parseLine(line);
+            } catch (const std::exception& e) {
+                std::cerr << "Line " << lineNumber << ": " << e.what() << std::endl;
+                ++failed;
+                continue;
+            }
+            if (!entry) {
+                continue;
+            }
+
+            if (renderer.renderToPng(entry->state, entry->output)) {
+                ++rendered;
+            } else {
+                std::cerr << "Failed to write " << entry->output << std::endl;
+                ++failed;
+            }
+        }
+
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Rendered " << rendered << " image(s) in " << elapsed << " s";
+        if (elapsed > 0.0) {
+            std::cout << " (" << rendered / elapsed << " images/s)";
+        }
+        std::cout << std::endl;
+
+        return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cerr << "Headless rendering failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,47 @@
+#include "headless_renderer.h"
+
+#include "include/core/SkSurface.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkPngEncoder.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+constexpr int defaultPngCompressionLevel = 1; // Favor throughput over file size
+
+HeadlessRenderer::HeadlessRenderer(int width, int height)
+    : _surface{SkSurfaces::Raster(SkImageInfo::Make(width, height, kRGBA_8888_SkColorType, kPremul_SkAlphaType))}
+    , _pngCompressionLevel{defaultPngCompressionLevel} {
+    if (!_surface) {
+        throw std::runtime_error("Failed to create raster surface");
+    }
+    if (!_surface->peekPixels(&_pixmap)) {
+        throw std::runtime_error("Failed to access raster surface pixels");
+    }
+    _bar = std::make_unique<SeekBar>(_surface->getCanvas(), width, height);
+}
+
+const SkPixmap& HeadlessRenderer::render(const SeekBarState& state) {
+    _bar->applyState(state);
+    _bar->draw();
+    return _pixmap;
+}
+
+bool HeadlessRenderer::renderToPng(const SeekBarState& state, const std::filesystem::path& outputPath) {
+    const SkPixmap& pixmap = render(state);
+
+    SkFILEWStream stream{outputPath.c_str()};
+    if (!stream.isValid()) {
+        return false;
+    }
+
+    SkPngEncoder::Options options;
+    options.fZLibLevel = _pngCompressionLevel;
+    // Sub filter only: seek bar rows are mostly flat runs of color, so trying every filter buys little
+    options.fFilterFlags = SkPngEncoder::FilterFlag::kSub;
+    return SkPngEncoder::Encode(&stream, pixmap, options);
+}
+
+void HeadlessRenderer::setPngCompressionLevel(const int level) {
+    _pngCompressionLevel = std::clamp(level, 0, 9);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "seek_bar.h"
+#include "seek_bar_state.h"
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkPixmap.h"
+
+#include <filesystem>
+#include <memory>
+
+class SkSurface;
+
+// Renders SeekBar states into an offscreen raster surface without any window or GL context.
+// The surface, typeface and images are created once and reused for every render.
+class HeadlessRenderer {
+public:
+    HeadlessRenderer(int width, int height);
+
+    const SkPixmap& render(const SeekBarState& state);
+    bool renderToPng(const SeekBarState& state, const std::filesystem::path& outputPath);
+
+    void setPngCompressionLevel(const int level);
+
+private:
+    sk_sp<SkSurface> _surface;
+    std::unique_ptr<SeekBar> _bar;
+    SkPixmap _pixmap;
+    int _pngCompressionLevel;
+};
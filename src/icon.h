@@ -1,15 +1,21 @@
 #pragma once
 
-#include "include/core/SkRefCnt.h"
+#include "widget_tree.h"
 
-#include <string>
-
-class SkImage;
+enum class IconImage {
+    Play,
+    Pause,
+    Skip,
+    Volume,
+    Mute,
+    Count
+};
 
 struct Icon {
     double x;
     double y;
     double width;
     double height;
-    sk_sp<SkImage> image;
+    IconImage image;
+    WidgetKind widget; // Button the icon is drawn for
 };
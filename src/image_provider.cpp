@@ -1,40 +1,120 @@
 #include "image_provider.h"
+#include "embedded_assets.h"
 
+#include "include/core/SkCanvas.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkData.h"
+#include "include/core/SkSurface.h"
 
-ImageProvider::ImageProvider(const std::filesystem::path& parentDir)
-    : _playImage{SkImages::DeferredFromEncodedData(
-        SkData::MakeFromFileName((parentDir / "icons/play.png").c_str()))}
-    , _pauseImage{SkImages::DeferredFromEncodedData(
-        SkData::MakeFromFileName((parentDir / "icons/pause.png").c_str()))}
-    , _skipImage{SkImages::DeferredFromEncodedData(
-        SkData::MakeFromFileName((parentDir / "icons/skip.png").c_str()))}
-    , _volumeImage{SkImages::DeferredFromEncodedData(
-        SkData::MakeFromFileName((parentDir / "icons/volume.png").c_str()))}
-    , _muteImage{SkImages::DeferredFromEncodedData(
-        SkData::MakeFromFileName((parentDir / "icons/mute.png").c_str()))} {
-    if (!_playImage || !_pauseImage || !_skipImage || !_volumeImage || !_muteImage) {
-        throw std::runtime_error("Failed to create image from encoded data");
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+constexpr int atlasSpacing = 1; // Transparent gap between icons, keeps sampling from bleeding across them
+
+constexpr std::array<const char*, static_cast<size_t>(IconImage::Count)> iconFiles = {
+    "icons/play.png",
+    "icons/pause.png",
+    "icons/skip.png",
+    "icons/volume.png",
+    "icons/mute.png"
+};
+
+ImageProvider::ImageProvider(const std::filesystem::path& parentDir, const ImageDecodeMode mode) {
+    for (size_t i = 0; i < iconCount; ++i) {
+        _images[i] = SkImages::DeferredFromEncodedData(loadAsset(iconFiles[i], parentDir));
+        if (!_images[i]) {
+            throw std::runtime_error("Failed to create image from encoded data");
+        }
+    }
+
+    if (mode == ImageDecodeMode::Eager) {
+        decodeEagerly();
+        buildAtlas();
+    }
+}
+
+void ImageProvider::decodeEagerly() {
+    const auto start = std::chrono::steady_clock::now();
+
+    std::array<std::future<sk_sp<SkImage>>, iconCount> decoded;
+    for (size_t i = 0; i < iconCount; ++i) {
+        decoded[i] = std::async(std::launch::async, [image = _images[i]]() {
+            return image->makeRasterImage(nullptr);
+        });
+    }
+    for (size_t i = 0; i < iconCount; ++i) {
+        _images[i] = decoded[i].get();
+        if (!_images[i]) {
+            throw std::runtime_error("Failed to decode icon image");
+        }
+    }
+
+    _stats.decodeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ImageProvider::buildAtlas() {
+    // Single row is enough for a handful of icons
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+    for (const auto& image : _images) {
+        atlasWidth += image->width() + atlasSpacing;
+        atlasHeight = std::max(atlasHeight, image->height());
     }
+
+    auto surface = SkSurfaces::Raster(
+        SkImageInfo::Make(atlasWidth, atlasHeight, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    if (!surface) {
+        throw std::runtime_error("Failed to create icon atlas surface");
+    }
+
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+
+    int x = 0;
+    for (size_t i = 0; i < iconCount; ++i) {
+        canvas->drawImage(_images[i], x, 0);
+        _atlasRects[i] = SkRect::MakeXYWH(x, 0, _images[i]->width(), _images[i]->height());
+        x += _images[i]->width() + atlasSpacing;
+    }
+
+    _atlas = surface->makeImageSnapshot();
+    _stats.atlasBytes = _atlas->imageInfo().computeMinByteSize();
 }
 
 sk_sp<SkImage> ImageProvider::playImg() const {
-    return _playImage;
+    return image(IconImage::Play);
 }
 
 sk_sp<SkImage> ImageProvider::pauseImg() const {
-    return _pauseImage;
+    return image(IconImage::Pause);
 }
 
 sk_sp<SkImage> ImageProvider::skipImg() const {
-    return _skipImage;
+    return image(IconImage::Skip);
 }
 
 sk_sp<SkImage> ImageProvider::volumeImg() const {
-    return _volumeImage;
+    return image(IconImage::Volume);
 }
 
 sk_sp<SkImage> ImageProvider::muteImg() const {
-    return _muteImage;
+    return image(IconImage::Mute);
+}
+
+sk_sp<SkImage> ImageProvider::image(const IconImage icon) const {
+    return _images[static_cast<size_t>(icon)];
+}
+
+sk_sp<SkImage> ImageProvider::atlas() const {
+    return _atlas;
+}
+
+SkRect ImageProvider::atlasRect(const IconImage icon) const {
+    return _atlasRects[static_cast<size_t>(icon)];
+}
+
+const ImageProviderStats& ImageProvider::stats() const {
+    return _stats;
 }
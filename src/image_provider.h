@@ -1,14 +1,29 @@
 #pragma once
 
+#include "icon.h"
+
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 
+#include <array>
 #include <filesystem>
 
 class SkImage;
 
+enum class ImageDecodeMode {
+    Deferred,   // Icons are decoded lazily on first draw
+    Eager       // Icons are decoded in parallel up front and packed into one atlas image
+};
+
+struct ImageProviderStats {
+    double decodeMilliseconds = 0.0;
+    size_t atlasBytes = 0;
+};
+
 class ImageProvider {
 public:
-    ImageProvider(const std::filesystem::path& parentDir);
+    // Icons are taken from the binary when embedded, otherwise from parentDir (empty means assetDirectory())
+    ImageProvider(const std::filesystem::path& parentDir = {}, const ImageDecodeMode mode = ImageDecodeMode::Deferred);
 
     sk_sp<SkImage> playImg() const;
     sk_sp<SkImage> pauseImg() const;
@@ -16,10 +31,20 @@ public:
     sk_sp<SkImage> volumeImg() const;
     sk_sp<SkImage> muteImg() const;
 
+    sk_sp<SkImage> image(const IconImage icon) const;
+    sk_sp<SkImage> atlas() const; // Null in deferred mode
+    SkRect atlasRect(const IconImage icon) const;
+
+    const ImageProviderStats& stats() const;
+
 private:
-    sk_sp<SkImage> _playImage = nullptr;
-    sk_sp<SkImage> _pauseImage = nullptr;
-    sk_sp<SkImage> _skipImage = nullptr;
-    sk_sp<SkImage> _volumeImage = nullptr;
-    sk_sp<SkImage> _muteImage = nullptr;
+    void decodeEagerly();
+    void buildAtlas();
+
+    static constexpr size_t iconCount = static_cast<size_t>(IconImage::Count);
+
+    std::array<sk_sp<SkImage>, iconCount> _images;
+    std::array<SkRect, iconCount> _atlasRects;
+    sk_sp<SkImage> _atlas = nullptr;
+    ImageProviderStats _stats;
 };
@@ -0,0 +1,48 @@
+#include "input_queue.h"
+
+void InputQueue::pushCursorMove(const double x, const double y) {
+    if (!_events.empty() && _events.back().type == InputEventType::CursorMove) {
+        _events.back().x = x;
+        _events.back().y = y;
+        return;
+    }
+    _events.push_back({.type = InputEventType::CursorMove, .x = x, .y = y});
+}
+
+void InputQueue::pushButton(const int button, const bool pressed, const double x, const double y) {
+    _events.push_back({
+        .type = pressed ? InputEventType::ButtonPress : InputEventType::ButtonRelease,
+        .x = x,
+        .y = y,
+        .code = button});
+}
+
+void InputQueue::pushKey(const int key) {
+    _events.push_back({.type = InputEventType::KeyPress, .code = key});
+}
+
+void InputQueue::pushDrop(const int count, const char** paths) {
+    const size_t firstPath = _paths.size();
+    for (int i = 0; i < count; ++i) {
+        _paths.emplace_back(paths[i]);
+    }
+    _events.push_back({.type = InputEventType::Drop, .firstPath = firstPath, .pathCount = static_cast<size_t>(count)});
+}
+
+bool InputQueue::empty() const {
+    return _events.empty();
+}
+
+const std::vector<InputEvent>& InputQueue::events() const {
+    return _events;
+}
+
+const std::vector<std::string>& InputQueue::paths() const {
+    return _paths;
+}
+
+void InputQueue::clear() {
+    // Keeps capacity, so a steady stream of input does not allocate every frame
+    _events.clear();
+    _paths.clear();
+}
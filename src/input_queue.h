@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+enum class InputEventType {
+    CursorMove,
+    ButtonPress,
+    ButtonRelease,
+    KeyPress,
+    Drop
+};
+
+struct InputEvent {
+    InputEventType type;
+    double x = 0.0;
+    double y = 0.0;
+    int code = 0;           // Mouse button or key
+    size_t firstPath = 0;   // Range of dropped paths in InputQueue::paths()
+    size_t pathCount = 0;
+};
+
+// Collects window input between frames. Consecutive cursor moves collapse into the latest position,
+// while button, key and drop events keep their order relative to the moves around them.
+class InputQueue {
+public:
+    void pushCursorMove(const double x, const double y);
+    void pushButton(const int button, const bool pressed, const double x, const double y);
+    void pushKey(const int key);
+    void pushDrop(const int count, const char** paths);
+
+    bool empty() const;
+    const std::vector<InputEvent>& events() const;
+    const std::vector<std::string>& paths() const;
+    void clear();
+
+private:
+    std::vector<InputEvent> _events;
+    std::vector<std::string> _paths;
+};
@@ -0,0 +1,161 @@
+#include "input_trace.h"
+
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+constexpr std::string_view traceMagic = "seekbar-input";
+constexpr int traceVersion = 1;
+
+InputRecorder::InputRecorder(
+    const std::filesystem::path& outputPath, const double startTime, const int width, const int height)
+    : _file{outputPath}
+    , _startTime{startTime} {
+    if (!_file) {
+        throw std::runtime_error("Failed to open input trace for writing: " + outputPath.string());
+    }
+    _file << traceMagic << ' ' << traceVersion << ' ' << width << ' ' << height << '\n';
+    _file << std::fixed << std::setprecision(6);
+}
+
+void InputRecorder::record(const double time, const InputQueue& input) {
+    const double elapsed = time - _startTime;
+    for (const auto& event : input.events()) {
+        _file << elapsed << ' ';
+        switch (event.type) {
+        case InputEventType::CursorMove:
+            _file << "move " << event.x << ' ' << event.y << '\n';
+            break;
+        case InputEventType::ButtonPress:
+        case InputEventType::ButtonRelease:
+            _file << (event.type == InputEventType::ButtonPress ? "press " : "release ")
+                  << event.code << ' ' << event.x << ' ' << event.y << '\n';
+            break;
+        case InputEventType::KeyPress:
+            _file << "key " << event.code << '\n';
+            break;
+        case InputEventType::Drop:
+            _file << "drop " << event.pathCount << '\n';
+            for (size_t i = 0; i < event.pathCount; ++i) {
+                _file << input.paths()[event.firstPath + i] << '\n';
+            }
+            break;
+        }
+    }
+}
+
+InputReplayer::InputReplayer(const std::filesystem::path& tracePath)
+    : _next{0}
+    , _width{0}
+    , _height{0} {
+    std::ifstream file{tracePath};
+    if (!file) {
+        throw std::runtime_error("Failed to open input trace: " + tracePath.string());
+    }
+
+    std::string magic;
+    int version = 0;
+    if (!(file >> magic >> version >> _width >> _height) || magic != traceMagic || version != traceVersion) {
+        throw std::runtime_error("Not a seek bar input trace: " + tracePath.string());
+    }
+
+    std::string line;
+    std::getline(file, line);
+    size_t lineNumber = 1;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty()) {
+            continue;
+        }
+
+        std::istringstream stream{line};
+        double time = 0.0;
+        std::string type;
+        if (!(stream >> time >> type)) {
+            throw std::runtime_error("Malformed input trace line " + std::to_string(lineNumber));
+        }
+        if (_batches.empty() || _batches.back().time != time) {
+            _batches.push_back({.time = time, .events = {}, .paths = {}});
+        }
+        Batch& batch = _batches.back();
+
+        InputEvent event{.type = InputEventType::CursorMove};
+        bool isValid = true;
+        if (type == "move") {
+            isValid = static_cast<bool>(stream >> event.x >> event.y);
+        } else if (type == "press" || type == "release") {
+            event.type = type == "press" ? InputEventType::ButtonPress : InputEventType::ButtonRelease;
+            isValid = static_cast<bool>(stream >> event.code >> event.x >> event.y);
+        } else if (type == "key") {
+            event.type = InputEventType::KeyPress;
+            isValid = static_cast<bool>(stream >> event.code);
+        } else if (type == "drop") {
+            event.type = InputEventType::Drop;
+            event.firstPath = batch.paths.size();
+            isValid = static_cast<bool>(stream >> event.pathCount);
+            for (size_t i = 0; isValid && i < event.pathCount; ++i) {
+                isValid = static_cast<bool>(std::getline(file, batch.paths.emplace_back()));
+                ++lineNumber;
+            }
+        } else {
+            isValid = false;
+        }
+        if (!isValid) {
+            throw std::runtime_error("Malformed input trace line " + std::to_string(lineNumber));
+        }
+        batch.events.push_back(event);
+    }
+}
+
+int InputReplayer::width() const {
+    return _width;
+}
+
+int InputReplayer::height() const {
+    return _height;
+}
+
+bool InputReplayer::isFinished() const {
+    return _next == _batches.size();
+}
+
+double InputReplayer::nextTime() const {
+    return isFinished() ? std::numeric_limits<double>::infinity() : _batches[_next].time;
+}
+
+double InputReplayer::endTime() const {
+    return _batches.empty() ? 0.0 : _batches.back().time;
+}
+
+double InputReplayer::takeDue(const double time, InputQueue& input) {
+    double lastTime = -1.0;
+    std::vector<const char*> paths;
+
+    for (; !isFinished() && _batches[_next].time <= time; ++_next) {
+        const Batch& batch = _batches[_next];
+        for (const auto& event : batch.events) {
+            switch (event.type) {
+            case InputEventType::CursorMove:
+                input.pushCursorMove(event.x, event.y);
+                break;
+            case InputEventType::ButtonPress:
+            case InputEventType::ButtonRelease:
+                input.pushButton(event.code, event.type == InputEventType::ButtonPress, event.x, event.y);
+                break;
+            case InputEventType::KeyPress:
+                input.pushKey(event.code);
+                break;
+            case InputEventType::Drop:
+                paths.clear();
+                for (size_t i = 0; i < event.pathCount; ++i) {
+                    paths.push_back(batch.paths[event.firstPath + i].c_str());
+                }
+                input.pushDrop(static_cast<int>(paths.size()), paths.data());
+                break;
+            }
+        }
+        lastTime = batch.time;
+    }
+    return lastTime;
+}
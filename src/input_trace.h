@@ -0,0 +1,56 @@
+#pragma once
+
+#include "input_queue.h"
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+// Text format, one event per line, events of one batch share a timestamp (seconds since recording began):
+//   seekbar-input 1 <width> <height>
+//   <time> move <x> <y>
+//   <time> press|release <button> <x> <y>
+//   <time> key <code>
+//   <time> drop <count>      followed by <count> lines with one path each
+// Coordinates are in the logical units of a window of the recorded size, key and button codes are GLFW's.
+
+// Writes every batch of input the app handles, exactly as it is applied to the model
+class InputRecorder {
+public:
+    InputRecorder(const std::filesystem::path& outputPath, const double startTime, const int width, const int height);
+
+    void record(const double time, const InputQueue& input);
+
+private:
+    std::ofstream _file;
+    double _startTime;
+};
+
+// Feeds a recorded trace back batch by batch once the replay time reaches each batch's timestamp
+class InputReplayer {
+public:
+    explicit InputReplayer(const std::filesystem::path& tracePath);
+
+    int width() const;
+    int height() const;
+
+    bool isFinished() const;
+    double nextTime() const; // Infinity once finished
+    double endTime() const;
+
+    // Appends all batches due at time and returns the timestamp of the last one (negative if none was due)
+    double takeDue(const double time, InputQueue& input);
+
+private:
+    struct Batch {
+        double time;
+        std::vector<InputEvent> events;
+        std::vector<std::string> paths;
+    };
+
+    std::vector<Batch> _batches;
+    size_t _next;
+    int _width;
+    int _height;
+};
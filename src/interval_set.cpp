@@ -0,0 +1,75 @@
+#include "interval_set.h"
+
+#include <algorithm>
+#include <array>
+
+bool IntervalSet::insert(const double start, const double end) {
+    if (!(start < end)) {
+        return false;
+    }
+
+    // First interval that ends at or after start and the first one starting past end touch the new range
+    auto first = std::lower_bound(_intervals.begin(), _intervals.end(), start,
+        [](const Interval& interval, const double value) { return interval.end < value; });
+    auto last = std::upper_bound(first, _intervals.end(), end,
+        [](const double value, const Interval& interval) { return value < interval.start; });
+
+    if (first == last) {
+        _intervals.insert(first, Interval{start, end});
+        return true;
+    }
+
+    const Interval merged{std::min(start, first->start), std::max(end, std::prev(last)->end)};
+    if (std::next(first) == last && merged.start == first->start && merged.end == first->end) {
+        return false; // Already covered
+    }
+    *first = merged;
+    _intervals.erase(std::next(first), last);
+    return true;
+}
+
+bool IntervalSet::erase(const double start, const double end) {
+    if (!(start < end)) {
+        return false;
+    }
+
+    auto first = std::upper_bound(_intervals.begin(), _intervals.end(), start,
+        [](const double value, const Interval& interval) { return value < interval.end; });
+    auto last = std::lower_bound(first, _intervals.end(), end,
+        [](const Interval& interval, const double value) { return interval.start < value; });
+    if (first == last) {
+        return false;
+    }
+
+    // Parts of the outermost intervals that stick out of the erased range survive
+    std::array<Interval, 2> remainders;
+    size_t remainderCount = 0;
+    if (first->start < start) {
+        remainders[remainderCount++] = {first->start, start};
+    }
+    if (std::prev(last)->end > end) {
+        remainders[remainderCount++] = {end, std::prev(last)->end};
+    }
+
+    const auto position = _intervals.erase(first, last);
+    _intervals.insert(position, remainders.begin(), remainders.begin() + remainderCount);
+    return true;
+}
+
+void IntervalSet::clear() {
+    _intervals.clear();
+}
+
+bool IntervalSet::contains(const double value) const {
+    const auto it = std::upper_bound(_intervals.begin(), _intervals.end(), value,
+        [](const double v, const Interval& interval) { return v < interval.end; });
+    return it != _intervals.end() && it->start <= value;
+}
+
+const std::vector<Interval>& IntervalSet::intervals() const {
+    return _intervals;
+}
+
+bool IntervalSet::empty() const {
+    return _intervals.empty();
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+struct Interval {
+    double start;
+    double end; // Exclusive
+};
+
+// Sorted, non-overlapping half-open intervals. Inserting merges with every interval it touches,
+// erasing splits intervals, so the set always stays minimal.
+class IntervalSet {
+public:
+    // Both return true when the set changed
+    bool insert(const double start, const double end);
+    bool erase(const double start, const double end);
+    void clear();
+
+    bool contains(const double value) const;
+    const std::vector<Interval>& intervals() const;
+    bool empty() const;
+
+private:
+    std::vector<Interval> _intervals;
+};
@@ -1,176 +1,673 @@
 #define SK_GL
 
 #include "seek_bar.h"
+#include "clock.h"
+#include "frame_backend.h"
+#include "frame_profiler.h"
+#include "input_queue.h"
+#include "input_trace.h"
+#include "media_loader.h"
+#include "seek_bar_model.h"
+#include "triple_buffer.h"
 
 #include "GLFW/glfw3.h"
-#include "include/core/SkSurface.h"
+#include "include/core/SkCanvas.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <iostream>
 #include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
 
 constexpr int windowWidth = 960;
 constexpr int windowHeight = 640;
+constexpr int minWindowWidth = 320;
+constexpr int minWindowHeight = 240;
 constexpr double moveOffset = 20.0;
+constexpr std::string_view defaultTracePath = "seekbar_trace.json";
+constexpr double replayTailSeconds = 0.5; // Lets the last replayed input reach the screen before closing
+constexpr double simulatedBufferStep = 2.0; // seconds buffered per simulated download
 
 void errorCallback(int error, const char* description) {
     std::cerr << "Error " << error << " occured: " << description << std::endl;
 }
 
-void keyCallback(GLFWwindow* window, int key, [[maybe_unused]] int scancode, int action, [[maybe_unused]] int mods) {
-    SeekBar* bar = reinterpret_cast<SeekBar*>(glfwGetWindowUserPointer(window));
+// GLFW reports the cursor in window coordinates and the framebuffer in pixels. The seek bar is laid out
+// in logical units (framebuffer pixels divided by the content scale), which covers both macOS style
+// HiDPI (framebuffer larger than the window) and scaled displays on Windows and X11.
+struct Viewport {
+    int windowWidth = 0;
+    int framebufferWidth = 0;
+    int framebufferHeight = 0;
+    float contentScale = 1.0f;
+
+    int logicalWidth() const {
+        return static_cast<int>(framebufferWidth / contentScale);
+    }
 
-    if (!bar) {
-        std::cerr << "keyCallback: seek bar pointer after casting is null!" << std::endl;
-        return;
+    int logicalHeight() const {
+        return static_cast<int>(framebufferHeight / contentScale);
     }
 
-    if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window, GL_TRUE);
-    } else if (key == GLFW_KEY_RIGHT && action == GLFW_PRESS) {
-        bar->updateCursorPosition(bar->getCursorX() + moveOffset);
-    } else if (key == GLFW_KEY_LEFT && action == GLFW_PRESS) {
-        bar->updateCursorPosition(bar->getCursorX() - moveOffset);
+    // Window coordinates to logical units
+    double cursorScale() const {
+        return windowWidth > 0 ? framebufferWidth / (windowWidth * static_cast<double>(contentScale)) : 1.0;
     }
+
+    bool isEmpty() const {
+        return framebufferWidth <= 0 || framebufferHeight <= 0;
+    }
+};
+
+Viewport queryViewport(GLFWwindow* window) {
+    Viewport viewport;
+    int height = 0;
+    float scaleY = 1.0f;
+    glfwGetWindowSize(window, &viewport.windowWidth, &height);
+    glfwGetFramebufferSize(window, &viewport.framebufferWidth, &viewport.framebufferHeight);
+    glfwGetWindowContentScale(window, &viewport.contentScale, &scaleY);
+    if (viewport.contentScale <= 0.0f) {
+        viewport.contentScale = 1.0f;
+    }
+    return viewport;
 }
 
-void mouseButtonCallback(GLFWwindow* window, int button, int action, [[maybe_unused]] int mods) {
-    SeekBar* bar = reinterpret_cast<SeekBar*>(glfwGetWindowUserPointer(window));
+// Wakes the render thread when a new snapshot is published or a worker has something to show
+class RenderSignal {
+public:
+    void notify() {
+        {
+            std::lock_guard lock{_mutex};
+            _isPending = true;
+        }
+        _condition.notify_one();
+    }
 
-    if (!bar) {
-        std::cerr << "mouseButtonCallback: seek bar pointer after casting is null!" << std::endl;
-        return;
+    // Window contents were damaged (e.g. uncovered), the next frame has to be presented in full
+    void requestFullRedraw() {
+        {
+            std::lock_guard lock{_mutex};
+            _isPending = true;
+            _isFullRedrawRequested = true;
+        }
+        _condition.notify_one();
     }
 
-    double xpos, ypos;
-    glfwGetCursorPos(window, &xpos, &ypos);
+    bool takeFullRedraw() {
+        std::lock_guard lock{_mutex};
+        return std::exchange(_isFullRedrawRequested, false);
+    }
 
-    if (button == GLFW_MOUSE_BUTTON_LEFT) {
-        if (action == GLFW_PRESS) {
-            if (bar->isMouseWithinBar(xpos, ypos)) {
-                bar->updateCursorPosition(xpos);
-                bar->startCursorDragging();
-            }
-            bar->handleButtonClick(xpos, ypos);
-        } else if (action == GLFW_RELEASE) {
-            bar->stopCursorDragging();
+    // Only the latest size matters, intermediate ones from a window drag are dropped
+    void requestResize(const Viewport& viewport) {
+        {
+            std::lock_guard lock{_mutex};
+            _isPending = true;
+            _resize = viewport;
+        }
+        _condition.notify_one();
+    }
+
+    std::optional<Viewport> takeResize() {
+        std::lock_guard lock{_mutex};
+        return std::exchange(_resize, std::nullopt);
+    }
+
+    // Returns false once a stop is requested
+    bool wait(std::stop_token stopToken) {
+        std::unique_lock lock{_mutex};
+        if (!_condition.wait(lock, stopToken, [this]() { return _isPending; })) {
+            return false;
         }
+        _isPending = false;
+        return true;
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable_any _condition;
+    bool _isPending = false;
+    bool _isFullRedrawRequested = false;
+    std::optional<Viewport> _resize;
+};
+
+struct AppContext {
+    SeekBarModel* model = nullptr;
+    MediaLoader* loader = nullptr;
+    RenderSignal* renderSignal = nullptr;
+    const Clock* clock = nullptr;
+    InputRecorder* recorder = nullptr; // Optional
+    Viewport viewport;
+    std::filesystem::path tracePath;
+    InputQueue input;
+    GLFWcursor* arrowCursor = nullptr;
+    GLFWcursor* handCursor = nullptr;
+    GLFWcursor* currentCursor = nullptr;
+};
+
+AppContext* getContext(GLFWwindow* window, const char* caller) {
+    AppContext* context = reinterpret_cast<AppContext*>(glfwGetWindowUserPointer(window));
+
+    if (!context || !context->model) {
+        std::cerr << caller << ": app context pointer after casting is null!" << std::endl;
+        return nullptr;
+    }
+    return context;
+}
+
+// GLFW callbacks only record input, it is applied to the model in processInput()
+void keyCallback(GLFWwindow* window, int key, [[maybe_unused]] int scancode, int action, [[maybe_unused]] int mods) {
+    if (AppContext* context = getContext(window, "keyCallback"); context && action == GLFW_PRESS) {
+        context->input.pushKey(key);
     }
+}
 
-    if (bar->isCursorDragging()) {
-        bar->updateCursorPosition(xpos);
+void mouseButtonCallback(GLFWwindow* window, int button, int action, [[maybe_unused]] int mods) {
+    if (AppContext* context = getContext(window, "mouseButtonCallback")) {
+        double xpos, ypos;
+        glfwGetCursorPos(window, &xpos, &ypos);
+        const double scale = context->viewport.cursorScale();
+        context->input.pushButton(button, action == GLFW_PRESS, xpos * scale, ypos * scale);
     }
 }
 
 void cursorPosCallback(GLFWwindow* window, double xpos, double ypos) {
-    SeekBar* bar = reinterpret_cast<SeekBar*>(glfwGetWindowUserPointer(window));
+    if (AppContext* context = getContext(window, "cursorPosCallback")) {
+        const double scale = context->viewport.cursorScale();
+        context->input.pushCursorMove(xpos * scale, ypos * scale);
+    }
+}
 
-    if (!bar) {
-        std::cerr << "cursorPosCallback: seek bar pointer after casting is null!" << std::endl;
-        return;
+void dropCallback(GLFWwindow* window, int count, const char** paths) {
+    if (AppContext* context = getContext(window, "dropCallback")) {
+        context->input.pushDrop(count, paths);
+    }
+}
+
+// Applied right away rather than queued: cursor positions recorded after this depend on the new scale
+void handleResize(GLFWwindow* window, AppContext& context) {
+    const Viewport viewport = queryViewport(window);
+    if (viewport.isEmpty()) {
+        return; // Minimized
+    }
+
+    context.viewport = viewport;
+    context.model->resize(viewport.logicalWidth(), viewport.logicalHeight());
+    context.renderSignal->requestResize(viewport);
+}
+
+void framebufferSizeCallback(GLFWwindow* window, [[maybe_unused]] int width, [[maybe_unused]] int height) {
+    if (AppContext* context = getContext(window, "framebufferSizeCallback")) {
+        handleResize(window, *context);
+    }
+}
+
+void contentScaleCallback(GLFWwindow* window, [[maybe_unused]] float xscale, [[maybe_unused]] float yscale) {
+    if (AppContext* context = getContext(window, "contentScaleCallback")) {
+        handleResize(window, *context);
     }
+}
 
-    const auto cursorShape =
-        bar->isCursorDragging() || bar->isMouseWithinBar(xpos, ypos) || bar->isMouseWithinIcons(xpos, ypos)
-            ? GLFW_HAND_CURSOR
-            : GLFW_ARROW_CURSOR;
-    glfwSetCursor(window, glfwCreateStandardCursor(cursorShape));
+void windowRefreshCallback(GLFWwindow* window) {
+    if (AppContext* context = getContext(window, "windowRefreshCallback")) {
+        context->renderSignal->requestFullRedraw();
+    }
+}
 
-    if (bar->isCursorDragging()) {
-        bar->updateCursorPosition(xpos);
-        bar->setHoverForChapter(xpos);
-    } else if (bar->isMouseWithinBar(xpos, ypos)) {
-        bar->setCursorVisibility(true);
-        bar->setHoverForChapter(xpos);
+void writeTrace(const std::filesystem::path& path) {
+    if (FrameProfiler::instance().writeChromeTrace(path)) {
+        std::cout << "Frame trace written to " << path << " (open it in chrome://tracing or Perfetto)" << std::endl;
     } else {
-        bar->setCursorVisibility(false);
-        bar->resetHover();
+        std::cerr << "Failed to write frame trace to " << path << std::endl;
     }
 }
 
-void dropCallback(GLFWwindow* window, int count, const char** paths) {
-    SeekBar* bar = reinterpret_cast<SeekBar*>(glfwGetWindowUserPointer(window));
+void handleKey(GLFWwindow* window, AppContext& context, const int key) {
+    SeekBarModel* model = context.model;
 
-    if (!bar) {
-        std::cerr << "cursorPosCallback: seek bar pointer after casting is null!" << std::endl;
-        return;
+    if (key == GLFW_KEY_ESCAPE) {
+        glfwSetWindowShouldClose(window, GL_TRUE);
+    } else if (key == GLFW_KEY_RIGHT) {
+        model->updateCursorPosition(model->getCursorX() + moveOffset);
+    } else if (key == GLFW_KEY_LEFT) {
+        model->updateCursorPosition(model->getCursorX() - moveOffset);
+    } else if (key == GLFW_KEY_H) {
+        model->toggleHud();
+    } else if (key == GLFW_KEY_T) {
+        writeTrace(context.tracePath);
+    }
+}
+
+void handleMouseButton(SeekBarModel* model, const InputEvent& event) {
+    if (event.code == GLFW_MOUSE_BUTTON_LEFT) {
+        if (event.type == InputEventType::ButtonPress) {
+            if (model->isMouseWithinBar(event.x, event.y)) {
+                model->updateCursorPosition(event.x);
+                model->startCursorDragging();
+            }
+            model->handleButtonClick(event.x, event.y);
+        } else {
+            model->stopCursorDragging();
+        }
+    }
+
+    if (model->isCursorDragging()) {
+        model->updateCursorPosition(event.x);
+    }
+}
+
+void handleCursorMove(GLFWwindow* window, AppContext& context, const double xpos, const double ypos) {
+    SeekBarModel* model = context.model;
+
+    // One hit test per move: the bar or an enabled button under the pointer
+    const auto widget = model->widgetAt(xpos, ypos);
+    const bool isOverBar = widget == WidgetKind::Bar || widget == WidgetKind::Chapters;
+    GLFWcursor* cursor = model->isCursorDragging() || widget ? context.handCursor : context.arrowCursor;
+    if (cursor != context.currentCursor) {
+        glfwSetCursor(window, cursor);
+        context.currentCursor = cursor;
+    }
+
+    if (model->isCursorDragging()) {
+        model->updateCursorPosition(xpos);
+        model->setHoverForChapter(xpos);
+    } else if (isOverBar) {
+        model->setCursorVisibility(true);
+        model->setHoverForChapter(xpos);
+    } else {
+        model->setCursorVisibility(false);
+        model->resetHover();
+    }
+}
+
+void handleDrop(AppContext& context, const InputEvent& event) {
+    for (size_t i = 0; i < event.pathCount; i++) {
+        std::cout << "Dropped file: " << context.input.paths()[event.firstPath + i] << std::endl;
     }
 
-    for (int i = 0; i < count; i++) {
-        std::cout << "Dropped file: " << paths[i] << std::endl;
+    // Only the first file is loaded, the worker maps and parses it while the UI keeps running
+    if (event.pathCount > 0 && context.loader->start(context.input.paths()[event.firstPath])) {
+        context.model->startLoading();
+    }
+}
+
+void pollMediaLoader(SeekBarModel& model, MediaLoader& loader) {
+    if (!model.isLoading()) {
+        return;
     }
 
-    // Simulate indeterminate loading for few seconds
-    if (!bar->isLoading()) {
-        auto start = std::chrono::steady_clock::now();
-        bar->load(start);
+    model.setLoadingProgress(loader.progress());
+    if (auto result = loader.takeResult()) {
+        if (result->media) {
+            std::cout << "Loaded " << result->media->chapters.size() << " chapter(s) from "
+                      << result->media->source << std::endl;
+            model.finishLoading(
+                std::move(result->media->chapters), result->media->duration, std::move(result->media->waveform));
+        } else {
+            std::cerr << "Loading failed: " << result->error << std::endl;
+            model.cancelLoading();
+        }
     }
 }
 
-void render(const sk_sp<SkSurface>& surface, GLFWwindow* window) {
-    SeekBar* bar = reinterpret_cast<SeekBar*>(glfwGetWindowUserPointer(window));
+void processInput(GLFWwindow* window, AppContext& context) {
+    if (context.recorder && !context.input.empty()) {
+        context.recorder->record(context.clock->now(), context.input);
+    }
+
+    for (const auto& event : context.input.events()) {
+        switch (event.type) {
+        case InputEventType::CursorMove:
+            handleCursorMove(window, context, event.x, event.y);
+            break;
+        case InputEventType::ButtonPress:
+        case InputEventType::ButtonRelease:
+            handleMouseButton(context.model, event);
+            break;
+        case InputEventType::KeyPress:
+            handleKey(window, context, event.code);
+            break;
+        case InputEventType::Drop:
+            handleDrop(context, event);
+            break;
+        }
+    }
+    context.input.clear();
+}
 
-    if (!bar) {
-        std::cerr << "render: seek bar pointer after casting is null!" << std::endl;
+void printDamageStats(const DamageStats& stats) {
+    if (stats.frames == 0 || stats.totalPixels == 0) {
         return;
     }
 
-    glClear(GL_COLOR_BUFFER_BIT);
+    const double repaintedPercent = 100.0 * stats.damagedPixels / stats.totalPixels;
+    std::cout << "Damage stats: " << stats.frames << " frame(s), "
+              << stats.damagedPixels << " of " << stats.totalPixels << " pixels repainted ("
+              << repaintedPercent << "%), " << (stats.totalPixels - stats.damagedPixels) << " pixels saved" << std::endl;
+}
+
+void printProfileStats(const std::pmr::vector<ProfilePhaseStats>& stats) {
+    for (const auto& phase : stats) {
+        std::cout << "Frame phase " << phase.name << ": " << phase.count << " sample(s), p50 " << phase.p50
+                  << " ms, p95 " << phase.p95 << " ms, p99 " << phase.p99 << " ms" << std::endl;
+    }
+}
 
-    bar->draw();
+void printTextCacheStats(const TextCacheStats& stats) {
+    std::cout << "Text cache stats: " << stats.hits << " hit(s), " << stats.misses << " miss(es)" << std::endl;
+}
 
-    SkImageInfo info = surface->imageInfo();
-    SkPixmap pixmap;
+void render(SeekBar& bar, FrameBackend& backend, GLFWwindow* window) {
+    SEEKBAR_PROFILE_SCOPE("frame");
+    backend.beginFrame();
 
-    if (surface->peekPixels(&pixmap)) {
-        glDrawPixels(info.width(), info.height(), GL_RGBA, GL_UNSIGNED_BYTE, pixmap.addr());
+    if (!backend.keepsFrameContents()) {
+        bar.invalidate();
     }
+    bar.draw();
+    backend.endFrame(bar.lastDamage());
 
+    SEEKBAR_PROFILE_SCOPE("frame.present");
     glfwSwapBuffers(window);
 }
 
-void initOpenGL() {
-    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-    glEnable(GL_BLEND);
-    glEnable(GL_FRAMEBUFFER_SRGB);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+// Stands in for a downloader thread: buffers a few seconds at a time and starts over at the end
+void simulateBuffering(std::stop_token stopToken, BufferedRanges& ranges, RenderSignal& renderSignal) {
+    constexpr double simulatedLength = 600.0;
+    double bufferedEnd = 0.0;
+
+    while (!stopToken.stop_requested()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (bufferedEnd >= simulatedLength) {
+            ranges.clear();
+            bufferedEnd = 0.0;
+        }
+        ranges.add(bufferedEnd, bufferedEnd + simulatedBufferStep);
+        bufferedEnd += simulatedBufferStep;
+        renderSignal.notify();
+    }
+}
+
+// Owns the GL context: picks up the newest model snapshot, rasterizes it and presents, then sleeps
+// until the event thread or a worker signals. Input handling never waits for a frame to finish.
+void renderLoop(
+    std::stop_token stopToken,
+    GLFWwindow* window,
+    SeekBar& bar,
+    TripleBuffer<SeekBarState>& snapshots,
+    RenderSignal& renderSignal,
+    const RenderBackend requestedBackend,
+    const std::chrono::steady_clock::time_point startupBegin,
+    const bool exitAfterFirstFrame) {
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1);
+
+    std::unique_ptr<FrameBackend> backend = createFrameBackend(requestedBackend);
+    std::cout << "Rendering with the " << backend->name() << " backend on "
+              << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << std::endl;
+
+    SkCanvas* canvas = nullptr;
+    bool isFirstFrame = true;
+
+    do {
+        if (auto resize = renderSignal.takeResize()) {
+            const Viewport& viewport = *resize;
+            try {
+                canvas = backend->resize(viewport.framebufferWidth, viewport.framebufferHeight, viewport.contentScale);
+            } catch (const std::exception& e) {
+                std::cerr << "Falling back to the raster backend: " << e.what() << std::endl;
+                backend = createFrameBackend(RenderBackend::Raster);
+                canvas = backend->resize(viewport.framebufferWidth, viewport.framebufferHeight, viewport.contentScale);
+            }
+            bar.setCanvas(canvas);
+            bar.resize(viewport.logicalWidth(), viewport.logicalHeight(), viewport.contentScale);
+        }
+        if (!canvas) {
+            continue;
+        }
+
+        if (snapshots.update()) {
+            bar.applyState(snapshots.front());
+        }
+        if (renderSignal.takeFullRedraw()) {
+            bar.invalidate();
+        }
+        bar.pollThumbnails();
+        bar.pollBufferedRanges();
+
+        if (bar.needsRedraw()) {
+            render(bar, *backend, window);
+        }
+
+        if (isFirstFrame) {
+            const auto startupTime =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin);
+            std::cout << "Startup to first frame took " << startupTime.count() << " ms" << std::endl;
+            isFirstFrame = false;
+            if (exitAfterFirstFrame) {
+                glfwSetWindowShouldClose(window, GL_TRUE);
+                glfwPostEmptyEvent();
+            }
+        }
+    } while (renderSignal.wait(stopToken));
+
+    // GPU resources go away while the context is still current: the bar drops its layer textures with the
+    // canvas, then the backend releases the GrDirectContext
+    bar.setCanvas(nullptr);
+    backend.reset();
+    glfwMakeContextCurrent(nullptr);
 }
 
-int main(void) {
+int main(int argc, char** argv) {
+    const auto startupBegin = std::chrono::steady_clock::now();
+    std::unique_ptr<ThumbnailProvider> thumbnails;
+    bool isBufferingSimulated = false;
+    std::filesystem::path tracePath;
+    std::filesystem::path recordPath;
+    std::unique_ptr<InputReplayer> replayer;
+    RenderBackend renderBackend = RenderBackend::Raster;
+    bool exitAfterFirstFrame = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--storyboard" && i + 1 < argc) {
+            try {
+                thumbnails = std::make_unique<ThumbnailProvider>(StoryboardInfo::loadFromFile(argv[++i]));
+            } catch (const std::exception& e) {
+                std::cerr << "Hover previews disabled: " << e.what() << std::endl;
+            }
+        } else if (arg == "--simulate-buffering") {
+            isBufferingSimulated = true;
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (arg == "--record-input" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay-input" && i + 1 < argc) {
+            try {
+                replayer = std::make_unique<InputReplayer>(argv[++i]);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                exit(EXIT_FAILURE);
+            }
+        } else if (arg == "--backend" && i + 1 < argc
+                   && (std::strcmp(argv[i + 1], "raster") == 0 || std::strcmp(argv[i + 1], "gpu") == 0)) {
+            renderBackend = std::strcmp(argv[++i], "gpu") == 0 ? RenderBackend::Gpu : RenderBackend::Raster;
+        } else if (arg == "--exit-after-first-frame") {
+            exitAfterFirstFrame = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--storyboard <descriptor>] [--simulate-buffering] [--trace <output.json>]\n"
+                      << "       [--record-input <input.trace> | --replay-input <input.trace>] [--backend raster|gpu]\n"
+                      << "       [--exit-after-first-frame]" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
     glfwSetErrorCallback(errorCallback);
 
     if (!glfwInit()) {
         exit(EXIT_FAILURE);
     }
 
-    GLFWwindow* window = glfwCreateWindow(windowWidth, windowHeight, "Custom Seek Bar using Skia", nullptr, nullptr);
+    // Window size follows the monitor scale on platforms where the window is measured in pixels
+    glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
+    // Replays open the window at the recorded size, so the recorded coordinates hit the same spots
+    GLFWwindow* window = glfwCreateWindow(
+        replayer ? replayer->width() : windowWidth,
+        replayer ? replayer->height() : windowHeight,
+        "Custom Seek Bar using Skia",
+        nullptr,
+        nullptr);
 
     if (!window) {
         glfwTerminate();
         exit(EXIT_FAILURE);
     }
 
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+    glfwSetWindowSizeLimits(window, minWindowWidth, minWindowHeight, GLFW_DONT_CARE, GLFW_DONT_CARE);
+    const Viewport viewport = queryViewport(window);
+
+    // The render thread gives the bar its surface, sized from the first resize request
+    SeekBar bar{nullptr, viewport.logicalWidth(), viewport.logicalHeight()};
+    SeekBarModel model{viewport.logicalWidth(), viewport.logicalHeight()};
+    RenderSignal renderSignal;
+    renderSignal.requestResize(viewport);
+
+    // A replay runs on recorded time: the trace is paced by the steady clock, but everything time
+    // dependent sees the timestamps from the trace
+    ManualClock replayClock;
+    const Clock* clock = replayer ? static_cast<const Clock*>(&replayClock) : &Clock::steady();
+    bar.setClock(clock);
+
+    std::unique_ptr<InputRecorder> recorder;
+    if (!recordPath.empty()) {
+        try {
+            recorder = std::make_unique<InputRecorder>(
+                recordPath, clock->now(), viewport.logicalWidth(), viewport.logicalHeight());
+        } catch (const std::exception& e) {
+            std::cerr << "Input recording disabled: " << e.what() << std::endl;
+        }
+    }
 
-    initOpenGL();
+    const auto& iconStats = bar.imageProviderStats();
+    std::cout << "Icons decoded in " << iconStats.decodeMilliseconds << " ms, atlas uses "
+              << iconStats.atlasBytes << " bytes" << std::endl;
 
-    SkImageInfo imageInfo = SkImageInfo::Make(windowWidth, windowHeight, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
-    auto surface = SkSurfaces::Raster(imageInfo);
+    if (thumbnails) {
+        // Wake up the render thread so a freshly decoded sheet shows up without waiting for input
+        thumbnails->setOnSheetReady([&renderSignal]() { renderSignal.notify(); });
+        bar.setThumbnailProvider(thumbnails.get());
+    }
+
+    BufferedRanges bufferedRanges;
+    std::jthread bufferingSimulation;
+    if (isBufferingSimulated) {
+        bar.setBufferedRanges(&bufferedRanges);
+        bufferingSimulation = std::jthread{simulateBuffering, std::ref(bufferedRanges), std::ref(renderSignal)};
+    }
 
-    SeekBar bar{surface->getCanvas(), windowWidth, windowHeight};
-    glfwSetWindowUserPointer(window, &bar);
+    // Wake up the event loop whenever the loader moves the progress bar or finishes
+    auto loader = std::make_unique<MediaLoader>();
+    loader->setOnProgress([]() { glfwPostEmptyEvent(); });
+
+    AppContext context;
+    context.model = &model;
+    context.loader = loader.get();
+    context.renderSignal = &renderSignal;
+    context.clock = clock;
+    context.recorder = recorder.get();
+    context.viewport = viewport;
+    context.tracePath = tracePath.empty() ? std::filesystem::path{defaultTracePath} : tracePath;
+    context.arrowCursor = glfwCreateStandardCursor(GLFW_ARROW_CURSOR);
+    context.handCursor = glfwCreateStandardCursor(GLFW_HAND_CURSOR);
+    glfwSetWindowUserPointer(window, &context);
 
     glfwSetKeyCallback(window, keyCallback);
     glfwSetMouseButtonCallback(window, mouseButtonCallback);
     glfwSetCursorPosCallback(window, cursorPosCallback);
     glfwSetDropCallback(window, dropCallback);
+    glfwSetWindowRefreshCallback(window, windowRefreshCallback);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+    glfwSetWindowContentScaleCallback(window, contentScaleCallback);
+
+    TripleBuffer<SeekBarState> snapshots;
+    snapshots.back() = model.state();
+    snapshots.publish();
+    uint64_t publishedVersion = model.version();
+
+    // The event thread only handles input and publishes snapshots, the GL context moves to the render thread
+    std::jthread renderThread{
+        renderLoop, window, std::ref(bar), std::ref(snapshots), std::ref(renderSignal), renderBackend,
+        startupBegin, exitAfterFirstFrame};
+
+    const double replayStart = Clock::steady().now();
 
     while (!glfwWindowShouldClose(window)) {
-        render(surface, window);
-        glfwPollEvents();
+        double replayTime = 0.0;
+        if (replayer) {
+            // Live input is ignored while replaying, close the window to stop early
+            context.input.clear();
+            replayTime = Clock::steady().now() - replayStart;
+            if (const double batchTime = replayer->takeDue(replayTime, context.input); batchTime >= 0.0) {
+                replayClock.set(batchTime);
+            }
+            if (replayer->isFinished() && replayTime >= replayer->endTime() + replayTailSeconds) {
+                std::cout << "Replay finished after " << replayTime << " s" << std::endl;
+                glfwSetWindowShouldClose(window, GL_TRUE);
+            }
+        }
+
+        processInput(window, context);
+        if (glfwWindowShouldClose(window)) {
+            break;
+        }
+        pollMediaLoader(model, *loader);
+
+        if (model.version() != publishedVersion) {
+            snapshots.back() = model.state();
+            snapshots.publish();
+            publishedVersion = model.version();
+            renderSignal.notify();
+        }
+
+        // Sleep until input arrives, the loader posts an empty event when it has progress to report
+        if (replayer) {
+            const double wakeTime = std::min(replayer->nextTime(), replayer->endTime() + replayTailSeconds);
+            glfwWaitEventsTimeout(std::max(wakeTime - replayTime, 0.0));
+        } else {
+            glfwWaitEvents();
+        }
+    }
+
+    renderThread.request_stop();
+    renderThread.join();
+
+    printDamageStats(bar.damageStats());
+    printTextCacheStats(bar.textCacheStats());
+    printProfileStats(FrameProfiler::instance().stats());
+    if (!tracePath.empty()) {
+        writeTrace(tracePath);
+    }
+
+    // Stop decoding and loading before GLFW goes away, workers signal the window and the renderer
+    bar.setThumbnailProvider(nullptr);
+    thumbnails.reset();
+    loader.reset();
+    if (bufferingSimulation.joinable()) {
+        bufferingSimulation.request_stop();
+        bufferingSimulation.join();
     }
 
+    glfwDestroyCursor(context.arrowCursor);
+    glfwDestroyCursor(context.handCursor);
     glfwDestroyWindow(window);
     glfwTerminate();
 
@@ -0,0 +1,54 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+    : _data{nullptr}
+    , _size{0} {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        ::close(fd);
+        throw std::runtime_error("Not a regular file: " + path.string());
+    }
+    _size = static_cast<size_t>(info.st_size);
+
+    // mmap rejects empty mappings, an empty file is just an empty view
+    if (_size > 0) {
+        void* mapping = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Failed to map file: " + path.string());
+        }
+        ::madvise(mapping, _size, MADV_SEQUENTIAL);
+        _data = static_cast<const char*>(mapping);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (_data) {
+        ::munmap(const_cast<char*>(_data), _size);
+    }
+}
+
+const char* MappedFile::data() const {
+    return _data;
+}
+
+size_t MappedFile::size() const {
+    return _size;
+}
+
+std::string_view MappedFile::view() const {
+    return {_data, _size};
+}
@@ -0,0 +1,432 @@
+#include "media_loader.h"
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+namespace {
+
+constexpr size_t minProgressStep = 1 << 20; // Bytes parsed between two progress reports, at least
+constexpr size_t maxProgressReports = 100;
+constexpr std::array<std::string_view, 3> sidecarExtensions = {".chapters.vtt", ".vtt", ".ffmetadata"};
+
+// Returns false when loading should stop
+using ProgressCallback = std::function<bool(double)>;
+
+enum class MetadataFormat {
+    Unknown,
+    WebVtt,
+    FfMetadata
+};
+
+// Chapter with absolute times in seconds, before it is placed on the bar
+struct TimedChapter {
+    std::string label;
+    double start = 0.0;
+    double end = 0.0;
+};
+
+struct ParsedMetadata {
+    std::vector<TimedChapter> chapters;
+    double duration = 0.0;
+};
+
+std::string_view trim(std::string_view text) {
+    const auto first = text.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+}
+
+MetadataFormat detectFormat(std::string_view text) {
+    if (text.starts_with("\xEF\xBB\xBF")) {
+        text.remove_prefix(3);
+    }
+    if (text.starts_with("WEBVTT")) {
+        return MetadataFormat::WebVtt;
+    }
+    if (text.starts_with(";FFMETADATA")) {
+        return MetadataFormat::FfMetadata;
+    }
+    return MetadataFormat::Unknown;
+}
+
+template <typename T>
+std::optional<T> parseNumber(const std::string_view text) {
+    T value{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// Accepts "ss.fff", "mm:ss.fff" and "hh:mm:ss.fff"
+std::optional<double> parseTimestamp(std::string_view text) {
+    double seconds = 0.0;
+    for (int field = 0; field < 3; ++field) {
+        const auto colon = text.find(':');
+        const auto value = parseNumber<double>(text.substr(0, colon));
+        if (!value || *value < 0.0) {
+            return std::nullopt;
+        }
+        seconds = seconds * 60.0 + *value;
+        if (colon == std::string_view::npos) {
+            return seconds;
+        }
+        text.remove_prefix(colon + 1);
+    }
+    return std::nullopt;
+}
+
+// Calls parseLine for every line without its line break. Progress is reported at most
+// maxProgressReports times, returns false when onProgress asked to stop.
+template <typename F>
+bool forEachLine(const std::string_view text, const ProgressCallback& onProgress, F&& parseLine) {
+    const size_t progressStep = std::max(minProgressStep, text.size() / maxProgressReports);
+    size_t nextReport = progressStep;
+    size_t offset = 0;
+
+    while (offset < text.size()) {
+        size_t end = text.find('\n', offset);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(offset, end - offset);
+        if (line.ends_with('\r')) {
+            line.remove_suffix(1);
+        }
+        parseLine(line);
+        offset = end + 1;
+
+        if (offset >= nextReport) {
+            nextReport = offset + progressStep;
+            if (!onProgress(static_cast<double>(std::min(offset, text.size())) / text.size())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Every cue is a chapter: "start --> end [settings]" followed by the title, ended by a blank line
+ParsedMetadata parseWebVtt(const std::string_view text, const ProgressCallback& onProgress) {
+    ParsedMetadata parsed;
+    TimedChapter cue;
+    bool isInCue = false;
+
+    const bool isComplete = forEachLine(text, onProgress, [&](const std::string_view line) {
+        if (line.empty()) {
+            if (isInCue) {
+                parsed.chapters.push_back(std::move(cue));
+                isInCue = false;
+            }
+            return;
+        }
+
+        if (isInCue) {
+            if (!cue.label.empty()) {
+                cue.label += ' ';
+            }
+            cue.label += trim(line);
+            return;
+        }
+
+        const auto arrow = line.find("-->");
+        if (arrow == std::string_view::npos) {
+            return; // Header, cue identifier, NOTE or STYLE block
+        }
+        const std::string_view endField = trim(line.substr(arrow + 3));
+        const auto start = parseTimestamp(trim(line.substr(0, arrow)));
+        const auto end = parseTimestamp(endField.substr(0, endField.find_first_of(" \t")));
+        if (start && end) {
+            cue = TimedChapter{.label = {}, .start = *start, .end = *end};
+            isInCue = true;
+        }
+    });
+
+    if (!isComplete) {
+        throw std::runtime_error("Loading cancelled");
+    }
+    if (isInCue) {
+        parsed.chapters.push_back(std::move(cue));
+    }
+    return parsed;
+}
+
+std::string unescapeMetadata(const std::string_view value) {
+    std::string result;
+    result.reserve(value.size());
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '\\' && i + 1 < value.size()) {
+            ++i;
+        }
+        result += value[i];
+    }
+    return result;
+}
+
+// [CHAPTER] sections with TIMEBASE, START, END and title keys; an optional global "duration" key
+// (seconds or hh:mm:ss) covers media running past the last chapter
+ParsedMetadata parseFfMetadata(const std::string_view text, const ProgressCallback& onProgress) {
+    enum class Section { Global, Chapter, Other };
+
+    struct PendingChapter {
+        std::string title;
+        int64_t timebaseNum = 1;
+        int64_t timebaseDen = 1000;
+        std::optional<int64_t> start;
+        std::optional<int64_t> end;
+    };
+
+    ParsedMetadata parsed;
+    Section section = Section::Global;
+    PendingChapter chapter;
+
+    const auto finishChapter = [&]() {
+        if (section == Section::Chapter && chapter.start && chapter.end && chapter.timebaseDen > 0) {
+            const double timebase = static_cast<double>(chapter.timebaseNum) / chapter.timebaseDen;
+            parsed.chapters.push_back({
+                .label = std::move(chapter.title),
+                .start = *chapter.start * timebase,
+                .end = *chapter.end * timebase});
+        }
+        chapter = PendingChapter{};
+    };
+
+    const bool isComplete = forEachLine(text, onProgress, [&](const std::string_view line) {
+        if (line.empty() || line.front() == ';' || line.front() == '#') {
+            return;
+        }
+
+        if (line.front() == '[') {
+            finishChapter();
+            section = line == "[CHAPTER]" ? Section::Chapter : Section::Other;
+            return;
+        }
+
+        const auto separator = line.find('=');
+        if (separator == std::string_view::npos) {
+            return;
+        }
+        const std::string_view key = line.substr(0, separator);
+        const std::string_view value = line.substr(separator + 1);
+
+        if (section == Section::Global && (key == "duration" || key == "DURATION")) {
+            parsed.duration = parseTimestamp(value).value_or(0.0);
+        } else if (section == Section::Chapter) {
+            if (key == "TIMEBASE") {
+                const auto slash = value.find('/');
+                chapter.timebaseNum = parseNumber<int64_t>(value.substr(0, slash)).value_or(0);
+                chapter.timebaseDen = slash == std::string_view::npos
+                    ? 1
+                    : parseNumber<int64_t>(value.substr(slash + 1)).value_or(0);
+            } else if (key == "START") {
+                chapter.start = parseNumber<int64_t>(value);
+            } else if (key == "END") {
+                chapter.end = parseNumber<int64_t>(value);
+            } else if (key == "title") {
+                chapter.title = unescapeMetadata(value);
+            }
+        }
+    });
+
+    if (!isComplete) {
+        throw std::runtime_error("Loading cancelled");
+    }
+    finishChapter();
+    return parsed;
+}
+
+MediaInfo placeChapters(ParsedMetadata parsed, const std::filesystem::path& source) {
+    MediaInfo media;
+    media.source = source;
+    media.duration = parsed.duration;
+    for (const auto& chapter : parsed.chapters) {
+        media.duration = std::max(media.duration, chapter.end);
+    }
+    if (media.duration <= 0.0) {
+        throw std::runtime_error("No chapters or duration found in " + source.string());
+    }
+
+    std::stable_sort(parsed.chapters.begin(), parsed.chapters.end(), [](const auto& a, const auto& b) {
+        return a.start < b.start;
+    });
+
+    media.chapters.reserve(parsed.chapters.size());
+    for (auto& chapter : parsed.chapters) {
+        if (chapter.end <= chapter.start) {
+            continue;
+        }
+        if (chapter.label.empty()) {
+            chapter.label = "Chapter " + std::to_string(media.chapters.size() + 1);
+        }
+        media.chapters.push_back({
+            .label = std::move(chapter.label),
+            .start = std::clamp(chapter.start / media.duration, 0.0, 1.0),
+            .end = std::clamp(chapter.end / media.duration, 0.0, 1.0)});
+    }
+    // Also covers files whose chapters were all empty, e.g. zero-length cues
+    if (media.chapters.empty()) {
+        media.chapters.push_back({.label = source.stem().string(), .start = 0.0, .end = 1.0});
+    }
+    return media;
+}
+
+} // namespace
+
+MediaLoader::MediaLoader()
+    : _isBusy{false}
+    , _isCancelled{false}
+    , _hasResult{false}
+    , _progress{0.0} {
+}
+
+MediaLoader::~MediaLoader() {
+    _isCancelled = true;
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+bool MediaLoader::start(const std::filesystem::path& path) {
+    if (_isBusy) {
+        return false;
+    }
+    // The previous worker already published its result, joining only waits for it to return
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+
+    _isBusy = true;
+    _isCancelled = false;
+    _hasResult = false;
+    _progress = 0.0;
+    _worker = std::thread{[this, path]() { run(path); }};
+    return true;
+}
+
+bool MediaLoader::isBusy() const {
+    return _isBusy;
+}
+
+double MediaLoader::progress() const {
+    return _progress.load(std::memory_order_relaxed);
+}
+
+std::optional<MediaLoadResult> MediaLoader::takeResult() {
+    if (!_hasResult.exchange(false)) {
+        return std::nullopt;
+    }
+    std::lock_guard<std::mutex> lock{_mutex};
+    return std::move(_result);
+}
+
+void MediaLoader::setOnProgress(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _onProgress = std::move(callback);
+}
+
+void MediaLoader::run(const std::filesystem::path& path) {
+    MediaLoadResult result;
+    try {
+        result.media = load(path);
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _result = std::move(result);
+    }
+    _hasResult = true;
+    _isBusy = false;
+    reportProgress(1.0);
+}
+
+MediaInfo MediaLoader::load(const std::filesystem::path& path) {
+    // Mapping is cheap even for multi-GB media, only the first bytes are read to sniff the format
+    const MappedFile mediaFile{path};
+    const bool isWav = Waveform::isWav(mediaFile.view());
+
+    std::optional<MappedFile> sidecarFile;
+    std::filesystem::path source = path;
+    MetadataFormat format = detectFormat(mediaFile.view());
+
+    for (size_t i = 0; format == MetadataFormat::Unknown && i < sidecarExtensions.size(); ++i) {
+        std::filesystem::path sidecar = path;
+        sidecar.replace_extension(sidecarExtensions[i]);
+        std::error_code error;
+        if (sidecar == path || !std::filesystem::is_regular_file(sidecar, error)) {
+            continue;
+        }
+        sidecarFile.emplace(sidecar);
+        format = detectFormat(sidecarFile->view());
+        source = sidecar;
+    }
+    const std::string_view metadata = sidecarFile ? sidecarFile->view() : mediaFile.view();
+
+    // Peak extraction and the chapter parse share one determinate bar, each gets the part of it its
+    // byte count makes up, and the bar never moves back
+    const double waveformBytes = isWav ? static_cast<double>(mediaFile.size()) : 0.0;
+    const double metadataBytes = format != MetadataFormat::Unknown ? static_cast<double>(metadata.size()) : 0.0;
+    const double waveformShare = waveformBytes + metadataBytes > 0.0 ? waveformBytes / (waveformBytes + metadataBytes) : 0.0;
+    double reported = 0.0;
+    const auto phaseProgress = [this, &reported](const double begin, const double end) -> ProgressCallback {
+        return [this, &reported, begin, end](const double progress) {
+            const double overall = begin + std::clamp(progress, 0.0, 1.0) * (end - begin);
+            if (overall > reported) {
+                reported = overall;
+                reportProgress(overall);
+            }
+            return !_isCancelled;
+        };
+    };
+
+    std::shared_ptr<const Waveform> waveform;
+    if (isWav) {
+        waveform = Waveform::fromWav(mediaFile.view(), _pool, phaseProgress(0.0, waveformShare));
+    }
+
+    ParsedMetadata parsed;
+    switch (format) {
+    case MetadataFormat::WebVtt:
+        parsed = parseWebVtt(metadata, phaseProgress(waveformShare, 1.0));
+        break;
+    case MetadataFormat::FfMetadata:
+        parsed = parseFfMetadata(metadata, phaseProgress(waveformShare, 1.0));
+        break;
+    case MetadataFormat::Unknown:
+        if (!waveform) {
+            throw std::runtime_error("No WebVTT or ffmetadata chapters found for " + path.string());
+        }
+        break;
+    }
+
+    // Without a sidecar a WAV file becomes one chapter spanning the whole audio
+    if (waveform) {
+        parsed.duration = std::max(parsed.duration, waveform->duration());
+    }
+    MediaInfo media = placeChapters(std::move(parsed), source);
+    media.waveform = std::move(waveform);
+    return media;
+}
+
+void MediaLoader::reportProgress(const double progress) {
+    _progress.store(progress, std::memory_order_relaxed);
+
+    std::function<void()> onProgress;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        onProgress = _onProgress;
+    }
+    if (onProgress) {
+        onProgress();
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "chapter.h"
+#include "thread_pool.h"
+#include "waveform.h"
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct MediaInfo {
+    std::filesystem::path source;   // File the chapters were read from
+    double duration = 0.0;          // Seconds
+    std::vector<Chapter> chapters;  // Positions relative to duration, sorted by start
+    std::shared_ptr<const Waveform> waveform; // Only set for WAV files
+};
+
+struct MediaLoadResult {
+    std::optional<MediaInfo> media; // Empty when loading failed
+    std::string error;
+};
+
+// Loads chapter metadata on a worker thread. Accepts WebVTT chapter files and ffmetadata files
+// directly; for any other file a sidecar (movie.chapters.vtt, movie.vtt, movie.ffmetadata) is used.
+// WAV files additionally get their waveform extracted and may go without a sidecar.
+// Files are memory-mapped and parsed line by line, so the calling thread never touches the disk.
+class MediaLoader {
+public:
+    MediaLoader();
+    ~MediaLoader();
+
+    MediaLoader(const MediaLoader&) = delete;
+    MediaLoader& operator=(const MediaLoader&) = delete;
+
+    // Returns false without doing anything while a previous load is still running
+    bool start(const std::filesystem::path& path);
+    bool isBusy() const;
+    // Fraction of the metadata parsed so far (0.0 to 1.0)
+    double progress() const;
+    // Returns the outcome once after a load finished, never blocks on the worker
+    std::optional<MediaLoadResult> takeResult();
+    // Called from the worker thread whenever progress advanced visibly and when loading ends
+    void setOnProgress(std::function<void()> callback);
+
+private:
+    void run(const std::filesystem::path& path);
+    MediaInfo load(const std::filesystem::path& path);
+    void reportProgress(const double progress);
+
+    std::thread _worker;
+    std::atomic<bool> _isBusy;
+    std::atomic<bool> _isCancelled;
+    std::atomic<bool> _hasResult;
+    std::atomic<double> _progress;
+
+    std::mutex _mutex;
+    MediaLoadResult _result;
+    std::function<void()> _onProgress;
+
+    ThreadPool _pool; // Peak extraction for WAV files
+};
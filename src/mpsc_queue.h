@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free queue for many producers and a single consumer. Every cell carries a sequence
+// number telling whether it is free for the producer at that position or filled for the consumer,
+// so producers only contend on one atomic increment and never wait for each other or the consumer.
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity);
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread; returns false when the queue is full
+    bool tryPush(const T& value);
+    // Consumer thread only; returns false when the queue is empty
+    bool tryPop(T& value);
+
+    size_t capacity() const;
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> _cells;
+    size_t _mask;
+    alignas(64) std::atomic<size_t> _head; // Next position to push
+    alignas(64) size_t _tail;              // Next position to pop, owned by the consumer
+};
+
+template <typename T>
+MpscQueue<T>::MpscQueue(const size_t capacity)
+    : _cells{new Cell[std::bit_ceil(std::max<size_t>(capacity, 2))]}
+    , _mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1}
+    , _head{0}
+    , _tail{0} {
+    for (size_t i = 0; i <= _mask; ++i) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool MpscQueue<T>::tryPush(const T& value) {
+    size_t position = _head.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = _cells[position & _mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0) {
+            if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.value = value;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false; // The consumer has not freed this cell yet
+        } else {
+            position = _head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+bool MpscQueue<T>::tryPop(T& value) {
+    Cell& cell = _cells[_tail & _mask];
+    const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(_tail + 1) < 0) {
+        return false;
+    }
+
+    value = std::move(cell.value);
+    cell.sequence.store(_tail + _mask + 1, std::memory_order_release);
+    ++_tail;
+    return true;
+}
+
+template <typename T>
+size_t MpscQueue<T>::capacity() const {
+    return _mask + 1;
+}
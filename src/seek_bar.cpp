@@ -1,347 +1,846 @@
 #include "seek_bar.h"
 #include "utils.h"
+#ifdef SEEKBAR_ALLOCATION_CHECKS
+#include "allocation_counter.h"
+#endif
 
 #include "include/core/SkImage.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkFont.h"
-#include "include/ports/SkFontMgr_fontconfig.h"
+#include "include/core/SkRSXform.h"
+#include "include/core/SkSurface.h"
 
-#include <iostream>
-#include <fstream>
-#include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 
-constexpr int defaultLoadingTime = 5; // seconds
-constexpr int defaultFontSize = 20;
 constexpr int defaultMarkerWidth = 5;
 constexpr int defaultCursorRadius = 20;
-
-const double seekBarDuration = 600.0;
-
-const std::filesystem::path currentDir = std::filesystem::current_path();
-const std::filesystem::path parentDir = currentDir.parent_path();
-const std::filesystem::path absoluteParentDir = std::filesystem::absolute(parentDir);
-const std::filesystem::path defaultFontPath = absoluteParentDir / "fonts/Roboto-Regular.ttf";
-
-SeekBar::SeekBar(SkCanvas* canvas, int windowWidth, int windowHeight)
-    : _imageProvider{absoluteParentDir}
-    , _fontMgr{SkFontMgr_New_FontConfig(nullptr)}
-    , _typeface{_fontMgr->makeFromFile(defaultFontPath.c_str())}
+constexpr double defaultChapterHeight = 15.0;
+constexpr double maxThumbnailWidth = 160.0;
+constexpr size_t maxIconCount = 8;
+constexpr double minMarkerSpacing = defaultMarkerWidth + 2.0; // Markers closer than this would blend into one
+constexpr double hoveredChapterHeight = 20.0;
+constexpr double waveformHeight = 40.0;
+constexpr float hudFontSize = 12.0f;
+constexpr double hudLineHeight = 15.0;
+constexpr double hudMargin = 8.0;
+constexpr double hudWidth = 380.0;
+constexpr double hudRefreshSeconds = 0.25;
+
+SeekBar::SeekBar(SkCanvas* canvas, int windowWidth, int windowHeight, std::shared_ptr<SeekBarResources> resources)
+    : _resources{resources ? std::move(resources) : std::make_shared<SeekBarResources>()}
+    , _elapsedTimeLength{0}
     , _canvas{canvas}
-    , _windowWidth{windowWidth}
-    , _windowHeight{windowHeight}
-    , _padding{50.0}
-    , _width{_windowWidth - 2 * _padding}
+    , _layout{windowWidth, windowHeight}
+    , _scale{1.0f}
     , _height{15.0}
-    , _cursorX{50}
-    , _cursorY{_windowHeight / 2.0}
+    , _cursorX{_layout.padding}
     , _currentTime{0.0}
-    , _animationOffset{0.0}
+    , _duration{0.0}
+    , _loadingProgress{0.0}
+    , _loadState{LoadState::None}
     , _isPlaying{false}
     , _isMuted{false}
     , _isCursorVisible{false}
-    , _isCursorDragging{false}
-    , _isFileLoaded{false}
-    , _isIndeterminateLoading{false} {
-    if (!_typeface) {
-        throw std::runtime_error("Failed to load typeface from file");
-    }
-    _canvas->scale(1, -1);
-    _canvas->translate(0, -_canvas->getBaseLayerSize().height());
+    , _damage{SkRect::MakeWH(windowWidth, windowHeight)}
+    , _lastDamage{SkIRect::MakeEmpty()}
+    , _lastFrameAllocations{0}
+    , _layerContext{nullptr}
+    , _isStaticLayerDirty{true}
+    , _hoveredChapter{-1}
+    , _thumbnailProvider{nullptr}
+    , _bufferedRanges{nullptr}
+    , _clock{&Clock::steady()}
+    , _isHudVisible{false}
+    , _hudFont{_resources->font()}
+    , _isHudStale{true}
+    , _hudUpdatedAt{0.0}
+    , _hudLineLengths{}
+    , _hudLineCount{0} {
+    _hudFont.setSize(hudFontSize);
+    initPaints();
+    _layout.buildWidgets(_widgets);
+    setContent(SeekBarContent::placeholder());
+}
+
+void SeekBar::initPaints() {
+    _barPaint.setColor(SK_ColorGRAY);
+    _progressPaint.setColor(SK_ColorRED);
+    _markerPaint.setColor(SK_ColorWHITE);
+    _markerPaint.setStyle(SkPaint::kFill_Style);
+    _waveformPaint.setColor(SkColorSetRGB(0xC8, 0xC8, 0xD8));
+    _waveformPaint.setAntiAlias(true);
+    _textPaint.setColor(SK_ColorBLACK);
+    _textPaint.setAntiAlias(true);
+    _cursorPaint.setColor(SK_ColorRED);
+    _hudBackgroundPaint.setColor(SkColorSetARGB(0xD0, 0x20, 0x20, 0x20));
+    _hudTextPaint.setColor(SK_ColorWHITE);
 }
 
 void SeekBar::draw() {
+    SEEKBAR_PROFILE_SCOPE("bar.draw");
+#ifdef SEEKBAR_ALLOCATION_CHECKS
+    const AllocationScope allocationScope{_lastFrameAllocations};
+#endif
+    _frameArena.reset();
+    if (_isHudVisible && !_damage.isEmpty()) {
+        updateHud();
+    }
+
+    const SkRect clip = SkRect::Make(_damage.roundOut());
+    // Reset up front so state changes made while drawing (e.g. loading completion) request another frame
+    _damage.setEmpty();
+
+    // Measured against the window in device pixels, pooled surfaces can be much larger than it
+    SkIRect windowRect = _canvas->getTotalMatrix().mapRect(SkRect::MakeIWH(_layout.windowWidth, _layout.windowHeight)).roundOut();
+    if (!windowRect.intersect(SkIRect::MakeSize(_canvas->getBaseLayerSize()))) {
+        windowRect.setEmpty();
+    }
+    _lastDamage = _canvas->getTotalMatrix().mapRect(clip).roundOut();
+    if (!_lastDamage.intersect(windowRect)) {
+        _lastDamage.setEmpty();
+    }
+
+    _damageStats.frames++;
+    _damageStats.lastFramePixels = static_cast<uint64_t>(_lastDamage.width64() * _lastDamage.height64());
+    _damageStats.damagedPixels += _damageStats.lastFramePixels;
+    _damageStats.totalPixels += static_cast<uint64_t>(windowRect.width64() * windowRect.height64());
+
+    if (_lastDamage.isEmpty()) {
+        return;
+    }
+
+    SkAutoCanvasRestore autoRestore{_canvas, true};
+    _canvas->clipRect(clip);
     _canvas->clear(SK_ColorWHITE);
 
-    if (_isFileLoaded) {
-        drawFullBar();
-    } else {
+    switch (_loadState) {
+    case LoadState::None:
         drawDefaultBar();
+        break;
+    case LoadState::Loading:
+        drawLoadingProgress();
+        break;
+    case LoadState::Loaded:
+        drawFullBar();
+        break;
+    }
+
+    if (_isHudVisible) {
+        drawHud();
     }
 }
 
 void SeekBar::drawFullBar() {
-    if (_isIndeterminateLoading) {
-        drawIndeterminateLoading();
-    } else {
-        drawSeekBarDividedByChapters();
-        drawIcons();
-        drawElapsedTime();
-        if (_isCursorVisible) {
-            drawCursor();
-        }
+    drawStaticLayers();
+    drawHoverLabels();
+    drawElapsedTime();
+    if (_isCursorVisible) {
+        drawCursor();
     }
 }
 
 void SeekBar::drawDefaultBar() {
-    SkPaint paint;
-    paint.setColor(SK_ColorGRAY);
     SkRect unfilledRect = SkRect::MakeXYWH(
-        _padding,
-        _windowHeight / 2 - _height / 2,
-        _width,
+        _layout.padding,
+        _layout.windowHeight / 2 - _height / 2,
+        _layout.width,
         _height);
-    _canvas->drawRect(unfilledRect, paint);
+    _canvas->drawRect(unfilledRect, _barPaint);
 }
 
-void SeekBar::drawIndeterminateLoading() {
-    _animationOffset += 0.01;
+void SeekBar::drawLoadingProgress() {
+    SkRect unfilledRect = SkRect::MakeXYWH(
+        _layout.padding,
+        _layout.windowHeight / 2 - _height / 2,
+        _layout.width,
+        _height);
+    _canvas->drawRect(unfilledRect, _barPaint);
+
+    SkRect progressRect = SkRect::MakeXYWH(
+        _layout.padding,
+        _layout.windowHeight / 2 - _height / 2,
+        _layout.width * _loadingProgress,
+        _height);
+    _canvas->drawRect(progressRect, _progressPaint);
+}
 
-    if (_animationOffset > 1.0) {
-        _animationOffset = 0.0;
+void SeekBar::drawStaticLayers() {
+    SEEKBAR_PROFILE_SCOPE("bar.chapters");
+    if (_isStaticLayerDirty) {
+        rebuildStaticLayers();
     }
 
-    constexpr double segmentWidth = 250.0;
-    const double offset = _animationOffset * (_windowWidth - 350.0);
+    drawLayer(_staticLayer, _staticLayerBounds);
+    drawHoveredChapter(SK_ColorGRAY);
+    drawBufferedRanges();
+
+    // Played part of the bar is the red copy of the chapters cut off at the cursor
+    SkAutoCanvasRestore autoRestore{_canvas, true};
+    _canvas->clipRect(SkRect::MakeLTRB(
+        _playedLayerBounds.left(),
+        _playedLayerBounds.top(),
+        _cursorX,
+        _playedLayerBounds.bottom()));
+    drawLayer(_playedLayer, _playedLayerBounds);
+    drawHoveredChapter(SK_ColorRED);
+}
 
-    SkPaint animation;
-    animation.setColor(SK_ColorGRAY);
-    SkRect unfilledRect = SkRect::MakeXYWH(
-        _padding,
-        _windowHeight / 2 - _height / 2,
-        _width,
-        _height);
-    _canvas->drawRect(unfilledRect, animation);
-
-    animation.setColor(SK_ColorRED);
-    animation.setStyle(SkPaint::kFill_Style);
-    SkRect animatedRect = SkRect::MakeXYWH(
-        _padding + offset,
-        _windowHeight / 2 - _height / 2,
-        segmentWidth,
-        _height);
-    _canvas->drawRect(animatedRect, animation);
-
-    auto now = std::chrono::steady_clock::now();
-    if (std::chrono::duration_cast<std::chrono::seconds>(now - _start).count() >= defaultLoadingTime) {
-        _animationOffset = 0.0f;
-        _isIndeterminateLoading = false;
-        std::cout << "Loading file completed!" << std::endl;
-    }
-}
-
-void SeekBar::drawSeekBarDividedByChapters() {
-    SkPaint markerPaint;
-    markerPaint.setColor(SK_ColorWHITE);
-    markerPaint.setStyle(SkPaint::kFill_Style);
-
-    SkPaint labelPaint;
-    labelPaint.setColor(SK_ColorBLACK);
-    labelPaint.setAntiAlias(true);
-
-    SkFont font{_typeface, defaultFontSize};
-
-    SkPaint chapterPaint;
-    for (const auto& chapter : _chapters) {
-        const double startX = _padding + _width  * chapter.start;
-        const double endX = _padding + _width * chapter.end;
-
-        drawChapter(chapter, chapterPaint, startX, endX);
-        double markerStart = &chapter == &(_chapters.front()) ? endX : startX;
-        drawMarker(chapter, markerPaint, markerStart);
-
-        if (chapter.isHovered) {
-            SkRect chapterBounds;
-            font.measureText(chapter.label.c_str(), chapter.label.size(), SkTextEncoding::kUTF8, &chapterBounds);
-            float chapterWidth = chapterBounds.width();
-
-            _canvas->drawSimpleText(
-                chapter.label.c_str(),
-                chapter.label.size(),
-                SkTextEncoding::kUTF8,
-                chapter.mouseX - (chapterWidth / 2),
-                (_windowHeight / 2 - chapter.height / 2) - 40,
-                font,
-                labelPaint);
-
-            double timeAtCursor = ((chapter.mouseX - _padding) / _width) * seekBarDuration;
-            std::string timeLabel = formatTime(timeAtCursor);
-
-            SkRect timeBounds;
-            font.measureText(timeLabel.c_str(), timeLabel.length(), SkTextEncoding::kUTF8, &timeBounds);
-            float timeWidth = timeBounds.width();
-
-            _canvas->drawSimpleText(
-                timeLabel.c_str(),
-                timeLabel.size(),
-                SkTextEncoding::kUTF8,
-                chapter.mouseX - (timeWidth / 2),
-                (_windowHeight / 2 - chapter.height / 2) - 20,
-                font,
-                labelPaint);
+void SeekBar::drawHoveredChapter(const SkColor chapterColor) {
+    // Layers hold every chapter at the default height, the hovered one is raised on top of them so a
+    // hover change never rebuilds a layer
+    if (_hoveredChapter < 0) {
+        return;
+    }
+
+    const size_t index = static_cast<size_t>(_hoveredChapter);
+    const double startX = _chapterIndex.startX(index);
+    const double endX = _chapterIndex.endX(index);
+    _chapterPaint.setColor(chapterColor);
+    drawChapter(_canvas, {startX, endX, hoveredChapterHeight}, _chapterPaint);
+    // First chapter has its marker at the end, every other one at the start
+    drawMarker(_canvas, {index == 0 ? endX : startX, hoveredChapterHeight}, _markerPaint);
+}
+
+void SeekBar::drawBufferedRanges() {
+    if (!_bufferedRanges || !_bufferedLayer) {
+        return;
+    }
+
+    const double pixelsPerSecond = _layout.width / _duration;
+    for (const auto& range : _bufferedRanges->ranges().intervals()) {
+        const double startX = _layout.padding + range.start * pixelsPerSecond;
+        const double endX = _layout.padding + range.end * pixelsPerSecond;
+        // Played part covers everything left of the cursor anyway
+        if (endX <= _cursorX || startX >= _layout.padding + _layout.width + defaultMarkerWidth) {
+            continue;
         }
+
+        SkAutoCanvasRestore autoRestore{_canvas, true};
+        _canvas->clipRect(SkRect::MakeLTRB(
+            std::max(startX, _cursorX),
+            _playedLayerBounds.top(),
+            endX,
+            _playedLayerBounds.bottom()));
+        drawLayer(_bufferedLayer, _playedLayerBounds);
     }
 }
 
-void SeekBar::drawChapter(const Chapter& chapter, SkPaint& chapterPaint, const double startX, const double endX) {
-    chapterPaint.setColor(SK_ColorRED);
-    SkRect filledRect = SkRect::MakeXYWH(
-        startX,
-        _windowHeight / 2 - chapter.height / 2,
-        std::max(0.0, std::min(_cursorX - startX, chapter.width)),
-        chapter.height);
-    _canvas->drawRect(filledRect, chapterPaint);
+void SeekBar::rebuildStaticLayers() {
+    SEEKBAR_PROFILE_SCOPE("bar.rebuildLayers");
+    SkRect staticBounds = barBounds();
+    if (_content->waveform) {
+        staticBounds.join(waveformBounds());
+    }
+    for (const auto& icon : _icons) {
+        staticBounds.join(iconBounds(icon));
+    }
+    _staticLayerBounds = staticBounds.roundOut();
+    _playedLayerBounds = barBounds().roundOut();
+
+    _chapterLod.rebuild(_chapterIndex, _chapterUi, minMarkerSpacing);
+
+    _layerContext = _canvas ? _canvas->recordingContext() : nullptr;
+    _staticLayer = rasterizeLayer(_staticLayerBounds, [this](SkCanvas* canvas) {
+        drawWaveform(canvas);
+        drawSeekBarDividedByChapters(canvas, SK_ColorGRAY);
+        drawIcons(canvas);
+    });
+    _playedLayer = rasterizeLayer(_playedLayerBounds, [this](SkCanvas* canvas) {
+        drawSeekBarDividedByChapters(canvas, SK_ColorRED);
+    });
+    _bufferedLayer = !_bufferedRanges ? nullptr : rasterizeLayer(_playedLayerBounds, [this](SkCanvas* canvas) {
+        drawSeekBarDividedByChapters(canvas, SK_ColorLTGRAY);
+    });
+
+    _isStaticLayerDirty = false;
+}
 
-    chapterPaint.setColor(SK_ColorGRAY);
-    SkRect unfilledRect = SkRect::MakeXYWH(
-        std::min(endX, std::max(_cursorX, startX)),
-        _windowHeight / 2 - chapter.height / 2,
-        std::max(0.0, std::min(endX - _cursorX, chapter.width)),
-        chapter.height);
-    _canvas->drawRect(unfilledRect, chapterPaint);
+sk_sp<SkImage> SeekBar::rasterizeLayer(const SkIRect& bounds, const std::function<void(SkCanvas*)>& drawContent) const {
+    const int width = static_cast<int>(std::ceil(bounds.width() * _scale));
+    const int height = static_cast<int>(std::ceil(bounds.height() * _scale));
+    const SkImageInfo info = SkImageInfo::Make(width, height, kRGBA_8888_SkColorType, kPremul_SkAlphaType);
+    // Matches the target canvas, so layers stay on the GPU under Ganesh. Recording canvases cannot make
+    // surfaces, their layers are rasterized on the CPU.
+    sk_sp<SkSurface> surface = _canvas ? _canvas->makeSurface(info) : nullptr;
+    if (!surface) {
+        surface = SkSurfaces::Raster(info);
+    }
+    if (!surface) {
+        throw std::runtime_error("Failed to create static layer surface");
+    }
+
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->scale(_scale, _scale);
+    canvas->translate(-bounds.x(), -bounds.y());
+    drawContent(canvas);
+    return surface->makeImageSnapshot();
+}
+
+void SeekBar::drawLayer(const sk_sp<SkImage>& layer, const SkIRect& bounds) {
+    // Layers hold bounds * scale pixels, so this maps them 1:1 onto the device
+    _canvas->drawImageRect(layer, SkRect::Make(bounds), SkSamplingOptions{});
+}
+
+void SeekBar::drawWaveform(SkCanvas* canvas) {
+    if (_waveformPath.isEmpty()) {
+        return;
+    }
+
+    canvas->drawPath(_waveformPath, _waveformPaint);
+}
+
+void SeekBar::drawSeekBarDividedByChapters(SkCanvas* canvas, const SkColor chapterColor) {
+    _chapterPaint.setColor(chapterColor);
+
+    for (const auto& span : _chapterLod.spans()) {
+        drawChapter(canvas, span, _chapterPaint);
+    }
+    for (const auto& marker : _chapterLod.markers()) {
+        drawMarker(canvas, marker, _markerPaint);
+    }
+}
+
+void SeekBar::drawChapter(SkCanvas* canvas, const ChapterSpan& span, const SkPaint& chapterPaint) {
+    SkRect chapterRect = SkRect::MakeLTRB(
+        span.startX,
+        _layout.windowHeight / 2 - span.height / 2,
+        span.endX,
+        _layout.windowHeight / 2 + span.height / 2);
+    canvas->drawRect(chapterRect, chapterPaint);
 }
 
-void SeekBar::drawMarker(const Chapter& chapter, SkPaint& markerPaint, const double start) {
-    SkRect marker = SkRect::MakeXYWH(
-        start,
-        _windowHeight / 2 - chapter.height / 2,
+void SeekBar::drawMarker(SkCanvas* canvas, const ChapterMarker& marker, const SkPaint& markerPaint) {
+    SkRect markerRect = SkRect::MakeXYWH(
+        marker.x,
+        _layout.windowHeight / 2 - marker.height / 2,
         defaultMarkerWidth,
-        chapter.height);
-    _canvas->drawRect(marker, markerPaint);
+        marker.height);
+    canvas->drawRect(markerRect, markerPaint);
 }
 
-void SeekBar::drawIcons() {
-    for (const auto& icon : _icons) {
-        const double imageX = icon.x + (icon.width - icon.image->width()) / 2.0;
-        const double imageY = icon.y + (icon.height - icon.image->height()) / 2.0;
-        _canvas->drawImage(icon.image, imageX, imageY);
+void SeekBar::drawHoverLabels() {
+    SEEKBAR_PROFILE_SCOPE("bar.hoverText");
+
+    if (_hoveredChapter >= 0) {
+        const auto& chapter = _content->chapters[_hoveredChapter];
+        const double mouseX = _chapterUi.mouseX[_hoveredChapter];
+        const double height = hoveredChapterHeight;
+
+        const auto& label = _resources->textCache().get(chapter.label, _resources->font());
+        _canvas->drawTextBlob(
+            label.blob,
+            mouseX - (label.bounds.width() / 2),
+            (_layout.windowHeight / 2 - height / 2) - 40,
+            _textPaint);
+
+        double timeAtCursor = ((mouseX - _layout.padding) / _layout.width) * _duration;
+        char buffer[timeBufferSize];
+        const std::string_view timeLabel = formatTime(timeAtCursor, buffer, sizeof(buffer));
+        _resources->timeGlyphs().draw(
+            _canvas,
+            timeLabel,
+            mouseX - (_resources->timeGlyphs().measure(timeLabel).width() / 2),
+            (_layout.windowHeight / 2 - height / 2) - 20,
+            _textPaint);
+
+        if (_thumbnailProvider) {
+            _thumbnailProvider->draw(_canvas, timeAtCursor, thumbnailBounds(mouseX, height));
+        }
     }
 }
 
-void SeekBar::drawElapsedTime() {
-    SkPaint timePaint;
-    timePaint.setColor(SK_ColorBLACK);
-    timePaint.setAntiAlias(true);
+void SeekBar::drawIcons(SkCanvas* canvas) {
+    SEEKBAR_PROFILE_SCOPE("bar.icons");
+    const sk_sp<SkImage> atlas = _resources->imageProvider().atlas();
 
-    std::string elapsedTime = formatTime(_currentTime);
-    std::string totalTime = formatTime(seekBarDuration);
-    std::string timeText = elapsedTime + " / " + totalTime;
+    if (!atlas) {
+        for (const auto& icon : _icons) {
+            const sk_sp<SkImage> image = _resources->imageProvider().image(icon.image);
+            const double imageX = icon.x + (icon.width - image->width()) / 2.0;
+            const double imageY = icon.y + (icon.height - image->height()) / 2.0;
+            canvas->drawImage(image, imageX, imageY);
+        }
+        return;
+    }
+
+    // All icons come from one atlas image, so they go out as a single batched draw
+    std::array<SkRSXform, maxIconCount> transforms;
+    std::array<SkRect, maxIconCount> sources;
+    const int count = static_cast<int>(std::min(_icons.size(), maxIconCount));
+
+    for (int i = 0; i < count; ++i) {
+        const auto& icon = _icons[i];
+        sources[i] = _resources->imageProvider().atlasRect(icon.image);
+        const double imageX = icon.x + (icon.width - sources[i].width()) / 2.0;
+        const double imageY = icon.y + (icon.height - sources[i].height()) / 2.0;
+        transforms[i] = SkRSXform::Make(1.0f, 0.0f, imageX, imageY);
+    }
 
-    SkFont font{_typeface, defaultFontSize};
+    canvas->drawAtlas(
+        atlas.get(),
+        transforms.data(),
+        sources.data(),
+        nullptr,
+        count,
+        SkBlendMode::kSrcOver,
+        SkSamplingOptions{},
+        nullptr,
+        nullptr);
+}
 
-    _canvas->drawSimpleText(
-        timeText.c_str(),
-        timeText.size(),
-        SkTextEncoding::kUTF8,
-        _padding + 220,
-        _cursorY + 60,
-        font,
-        timePaint);
+void SeekBar::drawElapsedTime() {
+    SEEKBAR_PROFILE_SCOPE("bar.elapsedText");
+    _resources->timeGlyphs().draw(_canvas, elapsedTimeText(), _layout.padding + 220, _layout.centerY + 60, _textPaint);
 }
 
 void SeekBar::drawCursor() {
-    SkPaint paint;
-    paint.setColor(SK_ColorRED);
-    _canvas->drawCircle(_cursorX, _cursorY, defaultCursorRadius, paint);
+    SEEKBAR_PROFILE_SCOPE("bar.cursor");
+    _canvas->drawCircle(_cursorX, _layout.centerY, defaultCursorRadius, _cursorPaint);
 }
 
-void SeekBar::load(const std::chrono::time_point<std::chrono::steady_clock>& start) {
-    _cursorX = _padding;
-    _currentTime = 0.0;
-    _animationOffset = 0.0;
-    _start = start;
-    _isPlaying = false;
-    _isMuted = false;
-    _isFileLoaded = true;
-    _isIndeterminateLoading = true;
+void SeekBar::drawHud() {
+    const SkRect bounds = hudBounds();
+    _canvas->drawRect(bounds, _hudBackgroundPaint);
 
-    for (auto& chapter : _chapters) {
-        chapter.width = (chapter.end - chapter.start) * _width;
+    for (size_t i = 0; i < _hudLineCount; ++i) {
+        _canvas->drawSimpleText(
+            _hudLines[i].data(), _hudLineLengths[i], SkTextEncoding::kUTF8,
+            bounds.x() + hudMargin / 2, bounds.y() + (i + 1) * hudLineHeight, _hudFont, _hudTextPaint);
     }
-
-    _icons = std::vector<Icon>{
-        {_padding, _cursorY + 30, 50, 50, _imageProvider.playImg()},
-        {_padding + 70, _cursorY + 30, 50, 50, _imageProvider.skipImg()},
-        {_padding + 140, _cursorY + 30, 50, 50, _imageProvider.volumeImg()}
-    };
 }
 
-bool SeekBar::isMouseWithinBar(const double mouseX, const double mouseY) const {
-    return mouseX >= _padding && mouseX <= (_windowWidth - _padding)
-        && mouseY >= (_windowHeight / 2 - 20) && mouseY <= (_windowHeight / 2 + 20);
+void SeekBar::updateHud() {
+    const double now = _clock->now();
+    if (!_isHudStale && now - _hudUpdatedAt < hudRefreshSeconds) {
+        return;
+    }
+    _isHudStale = false;
+    _hudUpdatedAt = now;
+
+    const auto stats = FrameProfiler::instance().stats(&_frameArena);
+    _hudLineCount = 0;
+    for (const auto& phase : stats) {
+        if (_hudLineCount == maxHudLines) {
+            break;
+        }
+        const int length = std::snprintf(
+            _hudLines[_hudLineCount].data(), hudLineLength, "%.*s  p50 %.2f  p95 %.2f  p99 %.2f ms",
+            static_cast<int>(phase.name.size()), phase.name.data(), phase.p50, phase.p95, phase.p99);
+        _hudLineLengths[_hudLineCount++] = static_cast<size_t>(std::clamp(length, 0, static_cast<int>(hudLineLength) - 1));
+    }
+    if (_hudLineCount == 0) {
+        const int length = std::snprintf(_hudLines[0].data(), hudLineLength, "No timings (built without SEEKBAR_PROFILING?)");
+        _hudLineLengths[_hudLineCount++] = static_cast<size_t>(std::clamp(length, 0, static_cast<int>(hudLineLength) - 1));
+    }
+#ifdef SEEKBAR_ALLOCATION_CHECKS
+    if (_hudLineCount < maxHudLines) {
+        const int length = std::snprintf(_hudLines[_hudLineCount].data(), hudLineLength, "heap allocations last frame: %llu",
+            static_cast<unsigned long long>(_lastFrameAllocations));
+        _hudLineLengths[_hudLineCount++] = static_cast<size_t>(std::clamp(length, 0, static_cast<int>(hudLineLength) - 1));
+    }
+#endif
+    addDamage(hudBounds());
 }
 
-bool SeekBar::isMouseWithinIcons(const double mouseX, const double mouseY) const {
-    for (const auto& icon : _icons) {
-        if (!_isIndeterminateLoading &&
-            mouseX >= icon.x && mouseX <= icon.x + icon.width &&
-            mouseY >= icon.y && mouseY <= icon.y + icon.height) {
-            return true;
+void SeekBar::applyState(const SeekBarState& state) {
+    setContent(state.content ? state.content : SeekBarContent::placeholder());
+    setLoadState(state.loadState);
+    setLoadingProgress(state.loadingProgress);
+
+    if (state.isPlaying != _isPlaying || state.isMuted != _isMuted) {
+        // Only the buttons whose image changed are repainted
+        if (state.isPlaying != _isPlaying) {
+            markWidgetDirty(WidgetKind::PlayButton);
+        }
+        if (state.isMuted != _isMuted) {
+            markWidgetDirty(WidgetKind::VolumeButton);
         }
+        _isPlaying = state.isPlaying;
+        _isMuted = state.isMuted;
+        updateIconImages();
     }
+    addWidgetDamage();
+
+    setCursorTime(state.cursorTime);
+    setCursorVisibility(state.isCursorVisible);
+    setHudVisibility(state.isHudVisible);
+
+    if (_loadState == LoadState::Loaded && state.hoveredChapter >= 0
+        && static_cast<size_t>(state.hoveredChapter) < _chapterIndex.size()) {
+        const size_t index = static_cast<size_t>(state.hoveredChapter);
+        const double mouseX = state.hoverTime >= 0.0
+            ? _layout.timeToX(state.hoverTime, _duration)
+            : (_chapterIndex.startX(index) + _chapterIndex.endX(index)) / 2.0;
+        setHover(state.hoveredChapter, mouseX);
+    } else {
+        resetHover();
+    }
+}
 
-    return false;
+void SeekBar::setContent(std::shared_ptr<const SeekBarContent> content) {
+    if (content == _content) {
+        return;
+    }
+
+    // The hovered index and its label bounds refer to the old chapters, drop them before the swap
+    resetHover();
+    _content = std::move(content);
+    _duration = _content->duration;
+    _currentTime = std::clamp(_currentTime, 0.0, _duration);
+    _cursorX = _layout.timeToX(_currentTime, _duration);
+    updateElapsedTimeText();
+    layoutChapters();
+    layoutWaveform();
+    invalidate();
 }
 
-void SeekBar::handleButtonClick(const double mouseX, const double mouseY) {
-    for (size_t i = 0; i < _icons.size(); ++i) {
-        const auto& icon = _icons[i];
+void SeekBar::setLoadState(const LoadState loadState) {
+    if (loadState == _loadState) {
+        return;
+    }
 
-        if (mouseX >= icon.x && mouseX <= icon.x + icon.width &&
-            mouseY >= icon.y && mouseY <= icon.y + icon.height) {
-            if (i == 0) {
-                _isPlaying = !_isPlaying;
-                _icons[0].image = _isPlaying ? _imageProvider.pauseImg() : _imageProvider.playImg();
-                std::cout << (_isPlaying ? "Play" : "Pause") << " button clicked" << std::endl;
-            } else if (i == 1) {
-                std::cout << "Skip button clicked" << std::endl;
-            } else if (i == 2) {
-                _isMuted = !_isMuted;
-                _icons[2].image = _isMuted ? _imageProvider.muteImg() : _imageProvider.volumeImg();
-                std::cout << "Mute button clicked" << std::endl;
-            }
-            break;
-        }
+    if (loadState == LoadState::Loaded && _icons.empty()) {
+        createIcons();
+    } else if (loadState == LoadState::None) {
+        _icons.clear();
+        _isStaticLayerDirty = true;
+    }
+    if (loadState != LoadState::Loaded) {
+        resetHover();
+    }
+    _loadState = loadState;
+    invalidate();
+}
+
+void SeekBar::setLoadingProgress(const double progress) {
+    const double loadingProgress = std::clamp(progress, 0.0, 1.0);
+    if (_loadState != LoadState::Loading) {
+        _loadingProgress = loadingProgress;
+        return;
+    }
+    // Only repaint when the fill changes by at least a pixel
+    if (std::abs(loadingProgress - _loadingProgress) * _layout.width >= 1.0) {
+        _loadingProgress = loadingProgress;
+        addDamage(barBounds());
     }
 }
 
-void SeekBar::updateCursorPosition(const double mouseX) {
-    if (!_isIndeterminateLoading && _isFileLoaded) {
-        _cursorX = std::max(_padding, std::min(_windowWidth - _padding, mouseX));
-        _currentTime = ((_cursorX - _padding) / _width) * seekBarDuration;
+void SeekBar::setCursorTime(const double time) {
+    const double currentTime = std::clamp(time, 0.0, _duration);
+    if (currentTime == _currentTime) {
+        return;
     }
+
+    // Old and new cursor circles span the bar, so their union also covers the progress fill change
+    addDamage(cursorBounds());
+    addDamage(elapsedTimeBounds());
+    _currentTime = currentTime;
+    _cursorX = _layout.timeToX(_currentTime, _duration);
+    updateElapsedTimeText();
+    addDamage(cursorBounds());
+    addDamage(elapsedTimeBounds());
 }
 
 void SeekBar::setCursorVisibility(const bool visible) {
-    _isCursorVisible = visible;
+    if (_isCursorVisible != visible) {
+        _isCursorVisible = visible;
+        addDamage(cursorBounds());
+    }
 }
 
-void SeekBar::startCursorDragging() {
-    _isCursorDragging = true;
+void SeekBar::setHudVisibility(const bool visible) {
+    if (_isHudVisible != visible) {
+        _isHudVisible = visible;
+        _isHudStale = true; // Show fresh numbers right away
+        addDamage(hudBounds());
+    }
 }
 
-void SeekBar::stopCursorDragging() {
-    _isCursorDragging = false;
+void SeekBar::layoutChapters() {
+    _isStaticLayerDirty = true;
+    resetHover();
+
+    _chapterIndex.rebuild(_content->chapters, _layout.padding, _layout.width);
+    _chapterUi.reset(_content->chapters.size(), defaultChapterHeight);
+
+    // Shape chapter labels up front so hovering never has to; past the cache capacity they would only
+    // evict each other, so the rest are shaped on their first hover
+    auto& textCache = _resources->textCache();
+    const size_t preshapedCount = std::min(_content->chapters.size(), textCache.capacity());
+    for (size_t i = 0; i < preshapedCount; ++i) {
+        textCache.get(_content->chapters[i].label, _resources->font());
+    }
 }
 
-bool SeekBar::isCursorDragging() const {
-    return _isCursorDragging;
+void SeekBar::layoutWaveform() {
+    _isStaticLayerDirty = true;
+    _waveformPath.reset();
+    if (!_content->waveform) {
+        return;
+    }
+
+    // One peak per pixel column, the pyramid keeps this independent of the sample count
+    std::vector<PeakRange> columns(static_cast<size_t>(std::max(1.0, std::ceil(_layout.width))));
+    _content->waveform->peaks(0.0, _duration, columns);
+
+    // Upper edge left to right, then the lower edge back, filled as one shape
+    const double centerY = _layout.windowHeight / 2.0;
+    const double amplitude = waveformHeight / 2.0;
+    _waveformPath.incReserve(static_cast<int>(2 * columns.size() + 1));
+    _waveformPath.moveTo(_layout.padding, centerY - columns.front().max * amplitude);
+    for (size_t i = 0; i < columns.size(); ++i) {
+        _waveformPath.lineTo(_layout.padding + i + 0.5, centerY - columns[i].max * amplitude);
+    }
+    for (size_t i = columns.size(); i-- > 0;) {
+        _waveformPath.lineTo(_layout.padding + i + 0.5, centerY - columns[i].min * amplitude);
+    }
+    _waveformPath.close();
 }
 
-double SeekBar::getCursorX() const {
-    return _cursorX;
+void SeekBar::createIcons() {
+    // Reuses the vector's storage, reloading a file does not allocate
+    const auto icons = _layout.icons();
+    _icons.assign(icons.begin(), icons.end());
+    updateIconImages();
 }
 
-double SeekBar::getCursorY() const {
-    return _cursorY;
+void SeekBar::updateIconImages() {
+    _isStaticLayerDirty = true;
+    for (auto& icon : _icons) {
+        if (icon.widget == WidgetKind::PlayButton) {
+            icon.image = _isPlaying ? IconImage::Pause : IconImage::Play;
+        } else if (icon.widget == WidgetKind::VolumeButton) {
+            icon.image = _isMuted ? IconImage::Mute : IconImage::Volume;
+        }
+    }
 }
 
-void SeekBar::setHoverForChapter(const double xpos) {
-    for (auto& chapter : _chapters) {
-        double startX = _padding + _width  * chapter.start;
-        double endX = _padding + _width * chapter.end;
-        chapter.mouseX = xpos;
-        chapter.isHovered = xpos >= startX && xpos <= endX;
-        chapter.height = chapter.isHovered ? 20.0 : 15.0;
+void SeekBar::markWidgetDirty(const WidgetKind kind) {
+    if (const auto widget = _widgets.find(kind)) {
+        _widgets.markDirty(*widget);
+    }
+}
+
+void SeekBar::addWidgetDamage() {
+    const WidgetRect dirty = _widgets.takeDirtyRect();
+    if (!dirty.isEmpty()) {
+        addDamage(SkRect::MakeXYWH(dirty.x, dirty.y, dirty.width, dirty.height));
+    }
+}
+
+void SeekBar::setHover(const int chapter, const double mouseX) {
+    if (chapter != _hoveredChapter) {
+        resetHover();
+        _chapterUi.mouseX[chapter] = mouseX;
+        _chapterUi.isHovered[chapter] = 1;
+        _hoveredChapter = chapter;
+        addDamage(chapterBounds(chapter));
+        addDamage(hoverLabelBounds(chapter));
+    } else if (mouseX != _chapterUi.mouseX[chapter]) {
+        // Labels follow the mouse on the hovered chapter, nothing else changes
+        if (_thumbnailProvider) {
+            const int direction = mouseX > _chapterUi.mouseX[chapter] ? 1 : -1;
+            _thumbnailProvider->prefetch(_layout.xToTime(mouseX, _duration), direction);
+        }
+        addDamage(hoverLabelBounds(chapter));
+        _chapterUi.mouseX[chapter] = mouseX;
+        addDamage(hoverLabelBounds(chapter));
     }
 }
 
 void SeekBar::resetHover() {
-    for (auto& chapter : _chapters) {
-        chapter.isHovered = false;
-        chapter.height = 15.0;
+    if (_hoveredChapter < 0) {
+        return;
+    }
+    const size_t index = static_cast<size_t>(_hoveredChapter);
+    if (index >= _chapterUi.mouseX.size() || index >= _content->chapters.size()) {
+        // Left over from chapters that are gone, there is nothing of it to repaint
+        _hoveredChapter = -1;
+        invalidate();
+        return;
+    }
+
+    addDamage(chapterBounds(_hoveredChapter));
+    addDamage(hoverLabelBounds(_hoveredChapter));
+    _chapterUi.isHovered[_hoveredChapter] = 0;
+    _hoveredChapter = -1;
+}
+
+void SeekBar::setCanvas(SkCanvas* canvas) {
+    // Layers made under a GPU context are its textures and must not outlive it, raster layers carry
+    // over to any canvas (the wall swaps recording canvases every frame)
+    if ((canvas ? canvas->recordingContext() : nullptr) != _layerContext) {
+        _staticLayer.reset();
+        _playedLayer.reset();
+        _bufferedLayer.reset();
+        _layerContext = nullptr;
+        _isStaticLayerDirty = true;
+    }
+    _canvas = canvas;
+    invalidate();
+}
+
+void SeekBar::resize(const int windowWidth, const int windowHeight, const float scale) {
+    if (windowWidth == _layout.windowWidth && windowHeight == _layout.windowHeight && scale == _scale) {
+        return;
+    }
+
+    _layout = SeekBarLayout{windowWidth, windowHeight};
+    _layout.buildWidgets(_widgets);
+    _scale = scale;
+    _cursorX = _layout.timeToX(_currentTime, _duration);
+    layoutChapters();
+    layoutWaveform();
+    if (!_icons.empty()) {
+        createIcons();
+    }
+    invalidate();
+}
+
+void SeekBar::invalidate() {
+    addDamage(SkRect::MakeWH(_layout.windowWidth, _layout.windowHeight));
+}
+
+bool SeekBar::needsRedraw() const {
+    return !_damage.isEmpty();
+}
+
+SkIRect SeekBar::lastDamage() const {
+    return _lastDamage;
+}
+
+const DamageStats& SeekBar::damageStats() const {
+    return _damageStats;
+}
+
+uint64_t SeekBar::lastFrameAllocations() const {
+    return _lastFrameAllocations;
+}
+
+void SeekBar::addDamage(const SkRect& rect) {
+    // Outset by a pixel to cover anti-aliased edges
+    _damage.join(rect.makeOutset(1, 1));
+}
+
+SkRect SeekBar::barBounds() const {
+    return SkRect::MakeXYWH(_layout.padding, _layout.windowHeight / 2 - hoveredChapterHeight / 2, _layout.width + defaultMarkerWidth, hoveredChapterHeight);
+}
+
+SkRect SeekBar::waveformBounds() const {
+    return SkRect::MakeXYWH(_layout.padding, _layout.windowHeight / 2 - waveformHeight / 2, _layout.width + 1, waveformHeight).makeOutset(1, 1);
+}
+
+SkRect SeekBar::chapterBounds(const size_t index) const {
+    return SkRect::MakeLTRB(
+        _chapterIndex.startX(index),
+        _layout.windowHeight / 2 - hoveredChapterHeight / 2,
+        _chapterIndex.endX(index) + defaultMarkerWidth,
+        _layout.windowHeight / 2 + hoveredChapterHeight / 2);
+}
+
+SkRect SeekBar::hoverLabelBounds(const size_t index) const {
+    const auto& chapter = _content->chapters[index];
+    const double mouseX = _chapterUi.mouseX[index];
+    const double height = hoveredChapterHeight;
+
+    SkRect labelBounds = _resources->textCache().get(chapter.label, _resources->font()).bounds;
+    labelBounds.offset(mouseX - labelBounds.width() / 2, (_layout.windowHeight / 2 - height / 2) - 40);
+
+    char buffer[timeBufferSize];
+    SkRect timeBounds = _resources->timeGlyphs().measure(formatTime(((mouseX - _layout.padding) / _layout.width) * _duration, buffer, sizeof(buffer)));
+    timeBounds.offset(mouseX - timeBounds.width() / 2, (_layout.windowHeight / 2 - height / 2) - 20);
+
+    labelBounds.join(timeBounds);
+    if (_thumbnailProvider) {
+        labelBounds.join(thumbnailBounds(mouseX, height));
+    }
+    return labelBounds;
+}
+
+SkRect SeekBar::thumbnailBounds(const double mouseX, const double chapterHeight) const {
+    const auto& info = _thumbnailProvider->info();
+    const double width = std::min<double>(maxThumbnailWidth, info.frameWidth);
+    const double height = width * info.frameHeight / info.frameWidth;
+    const double left = std::clamp(mouseX - width / 2, 0.0, std::max(0.0, _layout.windowWidth - width));
+    const double bottom = (_layout.windowHeight / 2 - chapterHeight / 2) - 65;
+    return SkRect::MakeXYWH(left, bottom - height, width, height);
+}
+
+SkRect SeekBar::cursorBounds() const {
+    return SkRect::MakeLTRB(
+        _cursorX - defaultCursorRadius,
+        _layout.centerY - defaultCursorRadius,
+        _cursorX + defaultCursorRadius,
+        _layout.centerY + defaultCursorRadius);
+}
+
+SkRect SeekBar::elapsedTimeBounds() const {
+    SkRect bounds = _resources->timeGlyphs().measure(elapsedTimeText());
+    bounds.offset(_layout.padding + 220, _layout.centerY + 60);
+    return bounds;
+}
+
+void SeekBar::updateElapsedTimeText() {
+    constexpr std::string_view separator = " / ";
+
+    size_t length = formatTime(_currentTime, _elapsedTimeText.data(), timeBufferSize).size();
+    std::copy(separator.begin(), separator.end(), _elapsedTimeText.begin() + length);
+    length += separator.size();
+    length += formatTime(_duration, _elapsedTimeText.data() + length, timeBufferSize).size();
+    _elapsedTimeLength = length;
+}
+
+std::string_view SeekBar::elapsedTimeText() const {
+    return {_elapsedTimeText.data(), _elapsedTimeLength};
+}
+
+SkRect SeekBar::iconBounds(const Icon& icon) const {
+    return SkRect::MakeXYWH(icon.x, icon.y, icon.width, icon.height);
+}
+
+SkRect SeekBar::hudBounds() const {
+    return SkRect::MakeXYWH(hudMargin, hudMargin, hudWidth, maxHudLines * hudLineHeight + hudMargin);
+}
+
+const TextCacheStats& SeekBar::textCacheStats() const {
+    return _resources->textCache().stats();
+}
+
+void SeekBar::setClock(const Clock* clock) {
+    _clock = clock ? clock : &Clock::steady();
+    _isHudStale = true;
+}
+
+void SeekBar::setThumbnailProvider(ThumbnailProvider* provider) {
+    _thumbnailProvider = provider;
+    if (_hoveredChapter >= 0) {
+        addDamage(hoverLabelBounds(_hoveredChapter));
+    }
+}
+
+void SeekBar::pollThumbnails() {
+    // A sheet decoded in the background may be the one the hovered preview is waiting for
+    if (_thumbnailProvider && _thumbnailProvider->takeReadySheets() && _hoveredChapter >= 0) {
+        addDamage(hoverLabelBounds(_hoveredChapter));
+    }
+}
+
+void SeekBar::setBufferedRanges(BufferedRanges* ranges) {
+    _bufferedRanges = ranges;
+    _isStaticLayerDirty = true;
+    addDamage(barBounds());
+}
+
+void SeekBar::pollBufferedRanges() {
+    if (_bufferedRanges && _bufferedRanges->drain() && _loadState == LoadState::Loaded) {
+        addDamage(barBounds());
     }
 }
 
-bool SeekBar::isLoading() const {
-    return _isIndeterminateLoading;
+const ImageProviderStats& SeekBar::imageProviderStats() const {
+    return _resources->imageProvider().stats();
 }
@@ -1,84 +1,202 @@
 #pragma once
 
+#include "buffered_ranges.h"
+#include "frame_arena.h"
+#include "frame_profiler.h"
 #include "image_provider.h"
 #include "chapter.h"
+#include "chapter_index.h"
+#include "chapter_lod.h"
+#include "clock.h"
 #include "icon.h"
-
+#include "seek_bar_layout.h"
+#include "seek_bar_resources.h"
+#include "seek_bar_state.h"
+#include "text_cache.h"
+#include "thumbnail_provider.h"
+#include "utils.h"
+#include "waveform.h"
+#include "widget_tree.h"
+
+#include "include/core/SkFont.h"
 #include "include/core/SkPaint.h"
-#include "include/core/SkFontMgr.h"
-#include "include/core/SkTypeface.h"
-
-#include <chrono>
+#include "include/core/SkPath.h"
+#include "include/core/SkRect.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 class SkSurface;
 class SkCanvas;
+class SkImage;
+class GrRecordingContext;
+
+struct DamageStats {
+    uint64_t frames = 0;
+    uint64_t damagedPixels = 0;    // Pixels repainted (and uploaded) over all frames
+    uint64_t totalPixels = 0;      // Pixels a full repaint would have touched over all frames
+    uint64_t lastFramePixels = 0;  // Pixels repainted in the most recent frame
+};
 
+// Renders SeekBarState snapshots. Consecutive states are diffed so only the parts that changed are
+// repainted; interaction lives in SeekBarModel, this class is only used from the rendering thread.
 class SeekBar {
 public:
-    SeekBar(SkCanvas* canvas, int windowWidth, int windowHeight);
+    // Bars given the same resources share the typeface, icons and text cache; null creates private ones
+    SeekBar(SkCanvas* canvas, int windowWidth, int windowHeight, std::shared_ptr<SeekBarResources> resources = nullptr);
 
     void draw();
-    void load(const std::chrono::time_point<std::chrono::steady_clock>& start);
+    void applyState(const SeekBarState& state);
 
-    bool isMouseWithinBar(const double mouseX, const double mouseY) const;
-    bool isMouseWithinIcons(const double mouseX, const double mouseY) const;
-    void handleButtonClick(const double mouseX, const double mouseY);
+    // Time source for everything time dependent (HUD refresh); not owned, the steady clock by default
+    void setClock(const Clock* clock);
 
-    void updateCursorPosition(const double mouseX);
-    void setCursorVisibility(const bool visible);
-    void startCursorDragging();
-    void stopCursorDragging();
-    bool isCursorDragging() const;
-    double getCursorX() const;
-    double getCursorY() const;
+    void setThumbnailProvider(ThumbnailProvider* provider);
+    void pollThumbnails();
 
-    void setHoverForChapter(const double xpos);
-    void resetHover();
+    // Applies range updates queued by producer threads, call once per frame
+    void setBufferedRanges(BufferedRanges* ranges);
+    void pollBufferedRanges();
 
-    bool isLoading() const;
+    // Retargets drawing, e.g. to a picture recorder; the next draw repaints everything
+    void setCanvas(SkCanvas* canvas);
+    // Window size in logical units; scale is the device pixels per unit the canvas is transformed by,
+    // cached layers are rasterized at that density so they stay sharp on HiDPI displays
+    void resize(const int windowWidth, const int windowHeight, const float scale = 1.0f);
+    void invalidate();
+    bool needsRedraw() const;
+
+    SkIRect lastDamage() const; // In device (surface pixel) coordinates
+    const DamageStats& damageStats() const;
+    // Heap allocations made by the last draw(); always 0 unless built with SEEKBAR_ALLOCATION_CHECKS
+    uint64_t lastFrameAllocations() const;
+    const TextCacheStats& textCacheStats() const;
+    const ImageProviderStats& imageProviderStats() const;
 
 private:
+    void initPaints();
     void drawFullBar();
     void drawDefaultBar();
-    void drawIndeterminateLoading();
-    void drawSeekBarDividedByChapters();
-    void drawChapter(const Chapter& chapter, SkPaint& chapterPaint, const double startX, const double endX);
-    void drawMarker(const Chapter& chapter, SkPaint& markerPaint, const double start);
-    void drawIcons();
+    void drawLoadingProgress();
+    void drawStaticLayers();
+    void drawBufferedRanges();
+    void drawHoveredChapter(const SkColor chapterColor);
+    void rebuildStaticLayers();
+    sk_sp<SkImage> rasterizeLayer(const SkIRect& bounds, const std::function<void(SkCanvas*)>& drawContent) const;
+    void drawLayer(const sk_sp<SkImage>& layer, const SkIRect& bounds);
+    void drawWaveform(SkCanvas* canvas);
+    void drawSeekBarDividedByChapters(SkCanvas* canvas, const SkColor chapterColor);
+    void drawChapter(SkCanvas* canvas, const ChapterSpan& span, const SkPaint& chapterPaint);
+    void drawMarker(SkCanvas* canvas, const ChapterMarker& marker, const SkPaint& markerPaint);
+    void drawHoverLabels();
+    void drawIcons(SkCanvas* canvas);
     void drawElapsedTime();
     void drawCursor();
+    void drawHud();
+    void updateHud();
+    void markWidgetDirty(const WidgetKind kind);
+    void addWidgetDamage();
+
+    void setContent(std::shared_ptr<const SeekBarContent> content);
+    void setLoadState(const LoadState loadState);
+    void setLoadingProgress(const double progress);
+    void setCursorTime(const double time);
+    void setCursorVisibility(const bool visible);
+    void setHudVisibility(const bool visible);
+    void setHover(const int chapter, const double mouseX);
+    void resetHover();
 
-    ImageProvider _imageProvider;
-
-    sk_sp<SkFontMgr> _fontMgr;
-    sk_sp<SkTypeface> _typeface;
+    void addDamage(const SkRect& rect);
+    SkRect barBounds() const;
+    SkRect waveformBounds() const;
+    SkRect chapterBounds(const size_t index) const;
+    SkRect hoverLabelBounds(const size_t index) const;
+    SkRect thumbnailBounds(const double mouseX, const double chapterHeight) const;
+    SkRect cursorBounds() const;
+    SkRect elapsedTimeBounds() const;
+    SkRect iconBounds(const Icon& icon) const;
+    SkRect hudBounds() const;
+    void updateElapsedTimeText();
+    std::string_view elapsedTimeText() const;
+
+    void layoutChapters();
+    void layoutWaveform();
+    void createIcons();
+    void updateIconImages();
+
+    std::shared_ptr<SeekBarResources> _resources; // Text cache is filled lazily, also from the const bounds helpers
+
+    std::array<char, 2 * timeBufferSize + 3> _elapsedTimeText; // "<elapsed> / <total>"
+    size_t _elapsedTimeLength;
 
     SkCanvas* _canvas;
 
-    int _windowWidth;
-    int _windowHeight;
-    double _padding;
-    double _width;
+    SeekBarLayout _layout;
+    float _scale;
     double _height;
     double _cursorX;
-    double _cursorY;
     double _currentTime;
-    double _animationOffset;
+    double _duration; // Seconds
+    double _loadingProgress;
+    LoadState _loadState;
     bool _isPlaying;
     bool _isMuted;
     bool _isCursorVisible; // Flag to track if the cursor should be visible
-    bool _isCursorDragging; // Flag to track if the user is _isCursorDragging the cursor
-    bool _isFileLoaded;
-    bool _isIndeterminateLoading;
-
-    std::chrono::time_point<std::chrono::steady_clock> _start;
-
-    std::vector<Chapter> _chapters = {
-        {.label = "Intro", .start = 0.0, .end = 0.2},
-        {.label = "Main Topic", .start = 0.2, .end = 0.5},
-        {.label = "Details", .start = 0.5, .end = 0.9},
-        {.label = "Outro", .start = 0.9, .end = 1.0}
-    };
+
+    SkRect _damage;        // Union of areas changed since the last draw, in seek bar coordinates
+    SkIRect _lastDamage;
+    DamageStats _damageStats;
+    uint64_t _lastFrameAllocations;
+    FrameArena _frameArena; // Transient data of the current draw, rewound at its start
+
+    // Set up once, drawing never constructs paints
+    SkPaint _barPaint;
+    SkPaint _progressPaint;
+    SkPaint _chapterPaint; // Color is set per layer
+    SkPaint _markerPaint;
+    SkPaint _waveformPaint;
+    SkPaint _textPaint;
+    SkPaint _cursorPaint;
+    SkPaint _hudBackgroundPaint;
+    SkPaint _hudTextPaint;
+
+    // Chapters and icons only change on load, resize and button toggles, so they are rasterized once
+    // and blitted every frame; the hovered chapter is drawn over them. The played and buffered layers are the same bar in red and light gray,
+    // clipped at the cursor and to the buffered ranges.
+    sk_sp<SkImage> _staticLayer;
+    sk_sp<SkImage> _playedLayer;
+    sk_sp<SkImage> _bufferedLayer; // Same bounds as the played layer
+    GrRecordingContext* _layerContext; // GPU context the layers were made under, null for raster layers
+    SkIRect _staticLayerBounds;
+    SkIRect _playedLayerBounds;
+    bool _isStaticLayerDirty;
+
+    std::shared_ptr<const SeekBarContent> _content;
+    ChapterUiState _chapterUi;
+    ChapterIndex _chapterIndex;
+    ChapterLod _chapterLod;
+    int _hoveredChapter; // Index of the hovered chapter, -1 when nothing is hovered
+    SkPath _waveformPath; // Envelope outline, rebuilt on layout only
     std::vector<Icon> _icons;
+    WidgetTree _widgets; // Same widgets as the model's, here for their dirty flags and invalidation rects
+    ThumbnailProvider* _thumbnailProvider; // Optional, not owned
+    BufferedRanges* _bufferedRanges;       // Optional, not owned
+    const Clock* _clock;                   // Not owned
+
+    // Refreshed only while something else is being repainted, so drawing the HUD never schedules
+    // another frame by itself
+    static constexpr size_t maxHudLines = 8;
+    static constexpr size_t hudLineLength = 80;
+    bool _isHudVisible;
+    SkFont _hudFont;
+    bool _isHudStale;
+    double _hudUpdatedAt; // Clock time of the last refresh
+    std::array<std::array<char, hudLineLength>, maxHudLines> _hudLines;
+    std::array<size_t, maxHudLines> _hudLineLengths;
+    size_t _hudLineCount;
 };
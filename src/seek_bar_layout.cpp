@@ -0,0 +1,47 @@
+#include "seek_bar_layout.h"
+
+#include <algorithm>
+
+constexpr double defaultPadding = 50.0;
+constexpr double iconSize = 50.0;
+constexpr double iconSpacing = 70.0;
+constexpr double iconOffsetY = 30.0;
+constexpr double barHitHeight = 20.0; // Distance from the bar center that still counts as on the bar
+
+SeekBarLayout::SeekBarLayout(const int windowWidth, const int windowHeight)
+    : windowWidth{windowWidth}
+    , windowHeight{windowHeight}
+    , padding{defaultPadding}
+    , width{std::max(windowWidth - 2 * defaultPadding, 1.0)} // Tiny windows still map x to time
+    , centerY{windowHeight / 2.0} {
+}
+
+double SeekBarLayout::timeToX(const double time, const double duration) const {
+    return padding + (time / duration) * width;
+}
+
+double SeekBarLayout::xToTime(const double x, const double duration) const {
+    return ((x - padding) / width) * duration;
+}
+
+std::array<Icon, SeekBarLayout::iconCount> SeekBarLayout::icons() const {
+    return {{
+        {padding, centerY + iconOffsetY, iconSize, iconSize, IconImage::Play, WidgetKind::PlayButton},
+        {padding + iconSpacing, centerY + iconOffsetY, iconSize, iconSize, IconImage::Skip, WidgetKind::SkipButton},
+        {padding + 2 * iconSpacing, centerY + iconOffsetY, iconSize, iconSize, IconImage::Volume, WidgetKind::VolumeButton}
+    }};
+}
+
+void SeekBarLayout::buildWidgets(WidgetTree& tree) const {
+    tree.clear();
+
+    const WidgetRect barArea{padding, centerY - barHitHeight, width, 2 * barHitHeight};
+    const size_t bar = tree.add(WidgetKind::Bar, std::nullopt, barArea, barArea);
+    tree.add(WidgetKind::Chapters, bar, barArea, barArea);
+
+    for (const auto& icon : icons()) {
+        const WidgetRect iconArea{icon.x, icon.y, icon.width, icon.height};
+        tree.add(icon.widget, std::nullopt, iconArea, iconArea);
+    }
+    tree.buildIndex(windowWidth, windowHeight);
+}
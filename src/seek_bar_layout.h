@@ -0,0 +1,26 @@
+#pragma once
+
+#include "icon.h"
+#include "widget_tree.h"
+
+#include <array>
+
+// Geometry shared by the model (hit testing) and the renderer (drawing), derived from the window size
+struct SeekBarLayout {
+    SeekBarLayout(const int windowWidth, const int windowHeight);
+
+    double timeToX(const double time, const double duration) const;
+    double xToTime(const double x, const double duration) const;
+    static constexpr size_t iconCount = 3;
+
+    // Play, skip and volume buttons below the bar, in this order
+    std::array<Icon, iconCount> icons() const;
+    // Bar with its chapters and one button per icon, indexed for hit testing
+    void buildWidgets(WidgetTree& tree) const;
+
+    int windowWidth;
+    int windowHeight;
+    double padding;
+    double width;
+    double centerY;
+};
@@ -0,0 +1,223 @@
+#include "seek_bar_model.h"
+
+#include <algorithm>
+#include <iostream>
+
+SeekBarModel::SeekBarModel(const int windowWidth, const int windowHeight)
+    : _layout{windowWidth, windowHeight}
+    , _loadStateBeforeLoading{LoadState::None}
+    , _isCursorDragging{false}
+    , _version{0} {
+    _state.loadState = LoadState::None;
+    _state.isCursorVisible = false;
+    setContent(SeekBarContent::placeholder());
+    rebuildWidgets();
+}
+
+void SeekBarModel::resize(const int windowWidth, const int windowHeight) {
+    if (windowWidth == _layout.windowWidth && windowHeight == _layout.windowHeight) {
+        return;
+    }
+
+    _layout = SeekBarLayout{windowWidth, windowHeight};
+    _chapterIndex.rebuild(_state.content->chapters, _layout.padding, _layout.width);
+    rebuildWidgets();
+    markChanged();
+}
+
+const SeekBarState& SeekBarModel::state() const {
+    return _state;
+}
+
+uint64_t SeekBarModel::version() const {
+    return _version;
+}
+
+std::optional<WidgetKind> SeekBarModel::widgetAt(const double mouseX, const double mouseY) const {
+    const auto found = _widgets.hitTest(mouseX, mouseY);
+    if (!found) {
+        return std::nullopt;
+    }
+    return _widgets.widget(*found).kind;
+}
+
+bool SeekBarModel::isMouseWithinBar(const double mouseX, const double mouseY) const {
+    const auto kind = widgetAt(mouseX, mouseY);
+    return kind == WidgetKind::Bar || kind == WidgetKind::Chapters;
+}
+
+bool SeekBarModel::isMouseWithinIcons(const double mouseX, const double mouseY) const {
+    const auto kind = widgetAt(mouseX, mouseY);
+    return kind == WidgetKind::PlayButton || kind == WidgetKind::SkipButton || kind == WidgetKind::VolumeButton;
+}
+
+void SeekBarModel::handleButtonClick(const double mouseX, const double mouseY) {
+    const auto kind = widgetAt(mouseX, mouseY);
+    if (!kind) {
+        return;
+    }
+
+    switch (*kind) {
+    case WidgetKind::PlayButton:
+        _state.isPlaying = !_state.isPlaying;
+        markChanged();
+        std::cout << (_state.isPlaying ? "Play" : "Pause") << " button clicked" << std::endl;
+        break;
+    case WidgetKind::SkipButton:
+        std::cout << "Skip button clicked" << std::endl;
+        break;
+    case WidgetKind::VolumeButton:
+        _state.isMuted = !_state.isMuted;
+        markChanged();
+        std::cout << "Mute button clicked" << std::endl;
+        break;
+    default:
+        break;
+    }
+}
+
+void SeekBarModel::updateCursorPosition(const double mouseX) {
+    if (_state.loadState != LoadState::Loaded) {
+        return;
+    }
+
+    const double cursorX = std::clamp(mouseX, _layout.padding, _layout.windowWidth - _layout.padding);
+    const double cursorTime = _layout.xToTime(cursorX, _state.content->duration);
+    if (cursorTime != _state.cursorTime) {
+        _state.cursorTime = cursorTime;
+        markChanged();
+    }
+}
+
+void SeekBarModel::setCursorVisibility(const bool visible) {
+    if (_state.isCursorVisible != visible) {
+        _state.isCursorVisible = visible;
+        markChanged();
+    }
+}
+
+void SeekBarModel::startCursorDragging() {
+    _isCursorDragging = true;
+}
+
+void SeekBarModel::stopCursorDragging() {
+    _isCursorDragging = false;
+}
+
+bool SeekBarModel::isCursorDragging() const {
+    return _isCursorDragging;
+}
+
+double SeekBarModel::getCursorX() const {
+    return _layout.timeToX(_state.cursorTime, _state.content->duration);
+}
+
+double SeekBarModel::getCursorY() const {
+    return _layout.centerY;
+}
+
+void SeekBarModel::setHoverForChapter(const double xpos) {
+    if (_state.loadState != LoadState::Loaded) {
+        return;
+    }
+
+    const auto found = _chapterIndex.findByX(xpos);
+    const int hoveredChapter = found ? static_cast<int>(*found) : -1;
+    const double hoverTime = found ? _layout.xToTime(xpos, _state.content->duration) : -1.0;
+
+    if (hoveredChapter != _state.hoveredChapter || hoverTime != _state.hoverTime) {
+        _state.hoveredChapter = hoveredChapter;
+        _state.hoverTime = hoverTime;
+        markChanged();
+    }
+}
+
+void SeekBarModel::resetHover() {
+    if (_state.hoveredChapter >= 0) {
+        _state.hoveredChapter = -1;
+        _state.hoverTime = -1.0;
+        markChanged();
+    }
+}
+
+void SeekBarModel::toggleHud() {
+    _state.isHudVisible = !_state.isHudVisible;
+    markChanged();
+}
+
+bool SeekBarModel::isLoading() const {
+    return _state.loadState == LoadState::Loading;
+}
+
+void SeekBarModel::startLoading() {
+    if (_state.loadState != LoadState::Loading) {
+        _loadStateBeforeLoading = _state.loadState;
+    }
+    _state.loadState = LoadState::Loading;
+    updateWidgetStates();
+    _state.loadingProgress = 0.0;
+    _isCursorDragging = false;
+    resetHover();
+    markChanged();
+}
+
+void SeekBarModel::setLoadingProgress(const double progress) {
+    const double loadingProgress = std::clamp(progress, 0.0, 1.0);
+    if (isLoading() && loadingProgress != _state.loadingProgress) {
+        _state.loadingProgress = loadingProgress;
+        markChanged();
+    }
+}
+
+void SeekBarModel::finishLoading(std::vector<Chapter> chapters, const double duration, std::shared_ptr<const Waveform> waveform) {
+    std::stable_sort(chapters.begin(), chapters.end(), [](const Chapter& lhs, const Chapter& rhs) {
+        return lhs.start < rhs.start;
+    });
+
+    auto content = std::make_shared<SeekBarContent>();
+    content->chapters = std::move(chapters);
+    content->duration = duration > 0.0 ? duration : SeekBarContent::placeholder()->duration;
+    content->waveform = std::move(waveform);
+    setContent(std::move(content));
+
+    _state.loadState = LoadState::Loaded;
+    updateWidgetStates();
+    _state.cursorTime = 0.0;
+    _state.isPlaying = false;
+    _state.isMuted = false;
+    markChanged();
+}
+
+void SeekBarModel::cancelLoading() {
+    if (isLoading()) {
+        _state.loadState = _loadStateBeforeLoading;
+        updateWidgetStates();
+        markChanged();
+    }
+}
+
+void SeekBarModel::setContent(std::shared_ptr<const SeekBarContent> content) {
+    _state.content = std::move(content);
+    _state.hoveredChapter = -1;
+    _state.hoverTime = -1.0;
+    _chapterIndex.rebuild(_state.content->chapters, _layout.padding, _layout.width);
+    markChanged();
+}
+
+void SeekBarModel::rebuildWidgets() {
+    _layout.buildWidgets(_widgets);
+    updateWidgetStates();
+}
+
+void SeekBarModel::updateWidgetStates() {
+    const bool areButtonsEnabled = _state.loadState == LoadState::Loaded;
+    for (const auto kind : {WidgetKind::PlayButton, WidgetKind::SkipButton, WidgetKind::VolumeButton}) {
+        if (const auto button = _widgets.find(kind)) {
+            _widgets.setEnabled(*button, areButtonsEnabled);
+        }
+    }
+}
+
+void SeekBarModel::markChanged() {
+    ++_version;
+}
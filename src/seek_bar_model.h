@@ -0,0 +1,65 @@
+#pragma once
+
+#include "chapter_index.h"
+#include "seek_bar_layout.h"
+#include "seek_bar_state.h"
+#include "widget_tree.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+// Interactive state of the seek bar, owned by the event thread. Input is applied here and the result
+// is exposed as a plain SeekBarState for the renderer; nothing in this class touches Skia.
+class SeekBarModel {
+public:
+    SeekBarModel(const int windowWidth, const int windowHeight);
+
+    // Window size in logical units; cursor time and hover are kept, only the geometry changes
+    void resize(const int windowWidth, const int windowHeight);
+
+    const SeekBarState& state() const;
+    // Bumped on every change, so callers publish a snapshot only when there is something new
+    uint64_t version() const;
+
+    // Enabled widget under the mouse; buttons only take input while a file is loaded
+    std::optional<WidgetKind> widgetAt(const double mouseX, const double mouseY) const;
+    bool isMouseWithinBar(const double mouseX, const double mouseY) const;
+    bool isMouseWithinIcons(const double mouseX, const double mouseY) const;
+    void handleButtonClick(const double mouseX, const double mouseY);
+
+    void updateCursorPosition(const double mouseX);
+    void setCursorVisibility(const bool visible);
+    void startCursorDragging();
+    void stopCursorDragging();
+    bool isCursorDragging() const;
+    double getCursorX() const;
+    double getCursorY() const;
+
+    void setHoverForChapter(const double xpos);
+    void resetHover();
+
+    void toggleHud();
+
+    // The previous content stays visible again if loading is cancelled
+    bool isLoading() const;
+    void startLoading();
+    void setLoadingProgress(const double progress);
+    void finishLoading(std::vector<Chapter> chapters, const double duration, std::shared_ptr<const Waveform> waveform);
+    void cancelLoading();
+
+private:
+    void setContent(std::shared_ptr<const SeekBarContent> content);
+    void rebuildWidgets();
+    void updateWidgetStates();
+    void markChanged();
+
+    SeekBarLayout _layout;
+    SeekBarState _state;
+    LoadState _loadStateBeforeLoading;
+    ChapterIndex _chapterIndex;
+    WidgetTree _widgets;
+    bool _isCursorDragging;
+    uint64_t _version;
+};
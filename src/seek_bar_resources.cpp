@@ -0,0 +1,47 @@
+#include "seek_bar_resources.h"
+#include "embedded_assets.h"
+
+#include "include/ports/SkFontMgr_fontconfig.h"
+
+#include <stdexcept>
+#include <string_view>
+
+constexpr int defaultFontSize = 20;
+
+constexpr std::string_view defaultFontAsset = "fonts/Roboto-Regular.ttf";
+
+namespace {
+
+sk_sp<SkTypeface> loadTypeface(const sk_sp<SkFontMgr>& fontMgr) {
+    sk_sp<SkTypeface> typeface = fontMgr->makeFromData(loadAsset(defaultFontAsset));
+    if (!typeface) {
+        throw std::runtime_error("Failed to load typeface from file");
+    }
+    return typeface;
+}
+
+} // namespace
+
+SeekBarResources::SeekBarResources()
+    : _imageProvider{{}, ImageDecodeMode::Eager}
+    , _fontMgr{SkFontMgr_New_FontConfig(nullptr)}
+    , _typeface{loadTypeface(_fontMgr)}
+    , _font{_typeface, defaultFontSize}
+    , _timeGlyphs{_font} {
+}
+
+const ImageProvider& SeekBarResources::imageProvider() const {
+    return _imageProvider;
+}
+
+const SkFont& SeekBarResources::font() const {
+    return _font;
+}
+
+const TimeGlyphs& SeekBarResources::timeGlyphs() const {
+    return _timeGlyphs;
+}
+
+TextCache& SeekBarResources::textCache() {
+    return _textCache;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "image_provider.h"
+#include "text_cache.h"
+#include "time_glyphs.h"
+
+#include "include/core/SkFont.h"
+#include "include/core/SkFontMgr.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkTypeface.h"
+
+// Typeface, icons and shaped text shared by every SeekBar created with them, so a wall of bars loads
+// the font and decodes the icons once. The text cache is filled while drawing, so bars sharing
+// resources must draw (or record) from one thread at a time; played back pictures need no locking.
+class SeekBarResources {
+public:
+    SeekBarResources();
+
+    SeekBarResources(const SeekBarResources&) = delete;
+    SeekBarResources& operator=(const SeekBarResources&) = delete;
+
+    const ImageProvider& imageProvider() const;
+    const SkFont& font() const;
+    const TimeGlyphs& timeGlyphs() const;
+    TextCache& textCache();
+
+private:
+    ImageProvider _imageProvider;
+
+    sk_sp<SkFontMgr> _fontMgr;
+    sk_sp<SkTypeface> _typeface;
+    SkFont _font;
+    TimeGlyphs _timeGlyphs;
+    TextCache _textCache;
+};
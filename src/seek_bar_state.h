@@ -0,0 +1,50 @@
+#pragma once
+
+#include "chapter.h"
+#include "waveform.h"
+
+#include <memory>
+#include <vector>
+
+enum class LoadState {
+    None,           // No file dropped yet, only the default gray bar is drawn
+    Loading,        // Progress bar is shown while chapters are being loaded
+    Loaded          // Chapters, icons and elapsed time are drawn
+};
+
+// What a loaded file puts on the bar. Immutable once built and shared by every snapshot showing it,
+// so publishing a state never copies chapters.
+struct SeekBarContent {
+    std::vector<Chapter> chapters;              // Sorted by start
+    double duration = 600.0;                    // Seconds
+    std::shared_ptr<const Waveform> waveform;   // Optional
+
+    // Demo chapters shown until a file is loaded, headless rendering keeps using them
+    static std::shared_ptr<const SeekBarContent> placeholder() {
+        static const auto content = std::make_shared<const SeekBarContent>(SeekBarContent{
+            .chapters = {
+                {.label = "Intro", .start = 0.0, .end = 0.2},
+                {.label = "Main Topic", .start = 0.2, .end = 0.5},
+                {.label = "Details", .start = 0.5, .end = 0.9},
+                {.label = "Outro", .start = 0.9, .end = 1.0}
+            },
+            .duration = 600.0,
+            .waveform = nullptr});
+        return content;
+    }
+};
+
+// Everything the renderer needs for one frame. The model publishes a copy per change, the renderer
+// diffs consecutive snapshots to find what to repaint.
+struct SeekBarState {
+    LoadState loadState = LoadState::Loaded;
+    double cursorTime = 0.0;        // Seconds from the beginning of the media
+    double loadingProgress = 0.0;   // Fraction of the file loaded (0.0 to 1.0)
+    int hoveredChapter = -1;        // Index of the hovered chapter, -1 when nothing is hovered
+    double hoverTime = -1.0;        // Time under the mouse, negative centers the labels on the hovered chapter
+    bool isPlaying = false;
+    bool isMuted = false;
+    bool isCursorVisible = true;
+    bool isHudVisible = false;      // Frame timing overlay, see FrameProfiler
+    std::shared_ptr<const SeekBarContent> content; // Null shows the placeholder chapters
+};
@@ -0,0 +1,156 @@
+#include "seek_bar_wall.h"
+#include "frame_profiler.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPictureRecorder.h"
+#include "include/core/SkSurface.h"
+
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+constexpr int tileSize = 256;
+
+SeekBarWall::SeekBarWall(
+    const int columns, const int rows, const int cellWidth, const int cellHeight, const size_t threadCount)
+    : _columns{columns}
+    , _rows{rows}
+    , _cellWidth{cellWidth}
+    , _cellHeight{cellHeight}
+    , _resources{std::make_shared<SeekBarResources>()}
+    , _pool{std::max<size_t>(threadCount, 1)} {
+    if (columns <= 0 || rows <= 0 || cellWidth <= 0 || cellHeight <= 0) {
+        throw std::runtime_error("Wall needs at least one cell of non-empty size");
+    }
+
+    const int width = columns * cellWidth;
+    const int height = rows * cellHeight;
+    _surface = SkSurfaces::Raster(SkImageInfo::Make(width, height, kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    if (!_surface) {
+        throw std::runtime_error("Failed to create wall surface");
+    }
+    if (!_surface->peekPixels(&_pixmap)) {
+        throw std::runtime_error("Failed to access wall surface pixels");
+    }
+
+    const size_t count = static_cast<size_t>(columns) * rows;
+    _bars.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        // The canvas is assigned right before every recording
+        _bars.push_back(std::make_unique<SeekBar>(nullptr, cellWidth, cellHeight, _resources));
+    }
+    _pictures.resize(count);
+    _isCellDirty.assign(count, 0);
+
+    for (int y = 0; y < height; y += tileSize) {
+        for (int x = 0; x < width; x += tileSize) {
+            _tiles.push_back(SkIRect::MakeLTRB(x, y, std::min(x + tileSize, width), std::min(y + tileSize, height)));
+        }
+    }
+}
+
+size_t SeekBarWall::size() const {
+    return _bars.size();
+}
+
+void SeekBarWall::applyState(const size_t index, const SeekBarState& state) {
+    _bars.at(index)->applyState(state);
+}
+
+const SkPixmap& SeekBarWall::render() {
+    SEEKBAR_PROFILE_SCOPE("wall.frame");
+    recordChangedCells();
+
+    std::vector<std::future<void>> pending;
+    for (const SkIRect& tile : _tiles) {
+        if (isTileDirty(tile)) {
+            pending.push_back(_pool.submit([this, tile]() { rasterizeTile(tile); }));
+        }
+    }
+    for (auto& tile : pending) {
+        tile.get();
+    }
+
+    _stats.frames++;
+    _stats.rasterizedTiles += pending.size();
+    std::fill(_isCellDirty.begin(), _isCellDirty.end(), 0);
+    return _pixmap;
+}
+
+const SeekBarWallStats& SeekBarWall::stats() const {
+    return _stats;
+}
+
+void SeekBarWall::recordChangedCells() {
+    SEEKBAR_PROFILE_SCOPE("wall.record");
+    // Recording goes through the shared text cache, so it stays on this thread; it is cheap next to
+    // rasterization, which is what the tiles spread across the pool
+    SkPictureRecorder recorder;
+    for (size_t i = 0; i < _bars.size(); ++i) {
+        SeekBar& bar = *_bars[i];
+        if (!bar.needsRedraw()) {
+            continue;
+        }
+
+        bar.setCanvas(recorder.beginRecording(SkRect::MakeWH(_cellWidth, _cellHeight)));
+        bar.draw();
+        _pictures[i] = recorder.finishRecordingAsPicture();
+        _isCellDirty[i] = 1;
+        _stats.recordedCells++;
+    }
+}
+
+void SeekBarWall::rasterizeTile(const SkIRect& tile) const {
+    SEEKBAR_PROFILE_SCOPE("wall.tile");
+    SkPixmap tilePixels;
+    if (!_pixmap.extractSubset(&tilePixels, tile)) {
+        return;
+    }
+    auto canvas = SkCanvas::MakeRasterDirect(tilePixels.info(), tilePixels.writable_addr(), tilePixels.rowBytes());
+    if (!canvas) {
+        return;
+    }
+    canvas->translate(-tile.x(), -tile.y());
+
+    const SkIRect cells = cellsInTile(tile);
+    for (int row = cells.top(); row < cells.bottom(); ++row) {
+        for (int column = cells.left(); column < cells.right(); ++column) {
+            const size_t index = static_cast<size_t>(row) * _columns + column;
+            if (!_isCellDirty[index] || !_pictures[index]) {
+                continue;
+            }
+
+            const SkIRect bounds = cellBounds(index);
+            SkAutoCanvasRestore autoRestore{canvas.get(), true};
+            canvas->clipIRect(bounds);
+            canvas->translate(bounds.x(), bounds.y());
+            canvas->drawPicture(_pictures[index]);
+        }
+    }
+}
+
+bool SeekBarWall::isTileDirty(const SkIRect& tile) const {
+    const SkIRect cells = cellsInTile(tile);
+    for (int row = cells.top(); row < cells.bottom(); ++row) {
+        for (int column = cells.left(); column < cells.right(); ++column) {
+            if (_isCellDirty[static_cast<size_t>(row) * _columns + column]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+SkIRect SeekBarWall::cellsInTile(const SkIRect& tile) const {
+    return SkIRect::MakeLTRB(
+        tile.left() / _cellWidth,
+        tile.top() / _cellHeight,
+        std::min((tile.right() - 1) / _cellWidth + 1, _columns),
+        std::min((tile.bottom() - 1) / _cellHeight + 1, _rows));
+}
+
+SkIRect SeekBarWall::cellBounds(const size_t index) const {
+    const int column = static_cast<int>(index % _columns);
+    const int row = static_cast<int>(index / _columns);
+    return SkIRect::MakeXYWH(column * _cellWidth, row * _cellHeight, _cellWidth, _cellHeight);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "seek_bar.h"
+#include "seek_bar_resources.h"
+#include "seek_bar_state.h"
+#include "thread_pool.h"
+
+#include "include/core/SkPicture.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class SkSurface;
+
+struct SeekBarWallStats {
+    uint64_t frames = 0;
+    uint64_t recordedCells = 0;   // Bars re-recorded because their state changed
+    uint64_t rasterizedTiles = 0;
+};
+
+// Renders a grid of seek bars into one raster surface. All bars share one set of resources. Changed
+// bars are recorded into pictures on the calling thread, then the tiles they touch are rasterized in
+// parallel by playing the pictures back, each tile writing only its own pixels.
+class SeekBarWall {
+public:
+    SeekBarWall(
+        const int columns,
+        const int rows,
+        const int cellWidth,
+        const int cellHeight,
+        const size_t threadCount = std::thread::hardware_concurrency());
+
+    size_t size() const;
+    void applyState(const size_t index, const SeekBarState& state);
+
+    const SkPixmap& render();
+
+    const SeekBarWallStats& stats() const;
+
+private:
+    void recordChangedCells();
+    void rasterizeTile(const SkIRect& tile) const;
+    bool isTileDirty(const SkIRect& tile) const;
+    SkIRect cellsInTile(const SkIRect& tile) const; // Column/row range of the cells a tile overlaps
+    SkIRect cellBounds(const size_t index) const;
+
+    int _columns;
+    int _rows;
+    int _cellWidth;
+    int _cellHeight;
+
+    std::shared_ptr<SeekBarResources> _resources;
+    sk_sp<SkSurface> _surface;
+    SkPixmap _pixmap;
+
+    std::vector<std::unique_ptr<SeekBar>> _bars;
+    std::vector<sk_sp<SkPicture>> _pictures;
+    std::vector<uint8_t> _isCellDirty;
+    std::vector<SkIRect> _tiles;
+    SeekBarWallStats _stats;
+
+    ThreadPool _pool; // Declared last so queued tiles never outlive the pictures and pixels they use
+};
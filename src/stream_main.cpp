@@ -0,0 +1,270 @@
+#include "headless_renderer.h"
+#include "media_loader.h"
+#include "video_stream_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr int defaultWidth = 960;
+constexpr int defaultHeight = 640;
+constexpr int defaultFramesPerSecond = 30;
+
+namespace {
+
+// Changes the hover script applies once the stream reaches time (seconds of output, not media time)
+struct ScriptEvent {
+    double time = 0.0;
+    std::optional<int> hoveredChapter;
+    std::optional<double> seek;
+    std::optional<bool> isCursorVisible;
+    std::optional<bool> isPlaying;
+    std::optional<bool> isMuted;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--width W] [--height H] [--fps N] [--format y4m|rgba] [--output <path>|-]\n"
+              << "       [--media <file>] [--start <seconds>] [--speed <media seconds per second>] [--frames N]\n"
+              << "       [--script <file>]\n"
+              << "\n"
+              << "Streams seek bar frames with the cursor advancing along the timeline, to stdout by default.\n"
+              << "Every non-empty line of the script (lines starting with '#' are skipped) changes the bar from\n"
+              << "then on:\n"
+              << "  <seconds> [hover=<chapter>|-1] [seek=<media seconds>] [cursor=0|1] [playing=0|1] [muted=0|1]\n";
+}
+
+bool parseBool(const std::string& value) {
+    return value == "1" || value == "true" || value == "yes";
+}
+
+std::optional<ScriptEvent> parseScriptLine(const std::string& line) {
+    std::istringstream stream{line};
+    ScriptEvent event;
+
+    std::string token;
+    if (!(stream >> token) || token.front() == '#') {
+        return std::nullopt;
+    }
+    event.time = std::stod(token);
+
+    while (stream >> token) {
+        const auto separator = token.find('=');
+        if (separator == std::string::npos) {
+            throw std::runtime_error("Expected key=value, got '" + token + "'");
+        }
+        const std::string key = token.substr(0, separator);
+        const std::string value = token.substr(separator + 1);
+
+        if (key == "hover") {
+            event.hoveredChapter = std::stoi(value);
+        } else if (key == "seek") {
+            event.seek = std::stod(value);
+        } else if (key == "cursor") {
+            event.isCursorVisible = parseBool(value);
+        } else if (key == "playing") {
+            event.isPlaying = parseBool(value);
+        } else if (key == "muted") {
+            event.isMuted = parseBool(value);
+        } else {
+            throw std::runtime_error("Unknown key '" + key + "'");
+        }
+    }
+
+    return event;
+}
+
+std::vector<ScriptEvent> loadScript(const std::string& path) {
+    std::ifstream file{path};
+    if (!file) {
+        throw std::runtime_error("Failed to open script: " + path);
+    }
+
+    std::vector<ScriptEvent> events;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        try {
+            if (auto event = parseScriptLine(line)) {
+                events.push_back(*event);
+            }
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Script line " + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+    std::stable_sort(events.begin(), events.end(), [](const ScriptEvent& lhs, const ScriptEvent& rhs) {
+        return lhs.time < rhs.time;
+    });
+    return events;
+}
+
+// Chapters and duration of a real file, so the burned-in bar matches the video it is laid over
+std::shared_ptr<const SeekBarContent> loadContent(const std::string& path) {
+    MediaLoader loader;
+    if (!loader.start(path)) {
+        throw std::runtime_error("Failed to start loading " + path);
+    }
+
+    std::optional<MediaLoadResult> result;
+    while (!(result = loader.takeResult())) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if (!result->media) {
+        throw std::runtime_error(result->error);
+    }
+
+    auto content = std::make_shared<SeekBarContent>();
+    content->chapters = std::move(result->media->chapters);
+    content->duration = result->media->duration > 0.0 ? result->media->duration : SeekBarContent::placeholder()->duration;
+    content->waveform = std::move(result->media->waveform);
+    return content;
+}
+
+void apply(const ScriptEvent& event, SeekBarState& state, double& mediaTime) {
+    if (event.hoveredChapter) {
+        state.hoveredChapter = *event.hoveredChapter;
+        state.hoverTime = -1.0;
+    }
+    if (event.seek) {
+        mediaTime = *event.seek;
+    }
+    if (event.isCursorVisible) {
+        state.isCursorVisible = *event.isCursorVisible;
+    }
+    if (event.isPlaying) {
+        state.isPlaying = *event.isPlaying;
+    }
+    if (event.isMuted) {
+        state.isMuted = *event.isMuted;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int width = defaultWidth;
+    int height = defaultHeight;
+    int framesPerSecond = defaultFramesPerSecond;
+    VideoStreamFormat format = VideoStreamFormat::Y4m;
+    std::string outputPath = "-";
+    std::string mediaPath;
+    std::string scriptPath;
+    double start = 0.0;
+    double speed = 1.0;
+    std::optional<long> frames;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--width" && i + 1 < argc) {
+            width = std::atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            height = std::atoi(argv[++i]);
+        } else if (arg == "--fps" && i + 1 < argc) {
+            framesPerSecond = std::atoi(argv[++i]);
+        } else if (arg == "--format" && i + 1 < argc) {
+            const std::string value = argv[++i];
+            if (value != "y4m" && value != "rgba") {
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            format = value == "rgba" ? VideoStreamFormat::Rgba : VideoStreamFormat::Y4m;
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (arg == "--media" && i + 1 < argc) {
+            mediaPath = argv[++i];
+        } else if (arg == "--start" && i + 1 < argc) {
+            start = std::atof(argv[++i]);
+        } else if (arg == "--speed" && i + 1 < argc) {
+            speed = std::atof(argv[++i]);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::atol(argv[++i]);
+        } else if (arg == "--script" && i + 1 < argc) {
+            scriptPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (width <= 0 || height <= 0 || framesPerSecond <= 0 || speed <= 0.0 || (frames && *frames < 0)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // A consumer that quits early (ffmpeg -t, head) should end the stream with an error, not a signal
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int fd = STDOUT_FILENO;
+    if (outputPath != "-") {
+        fd = ::open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "Failed to open " << outputPath << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    int status = EXIT_SUCCESS;
+    try {
+        const std::vector<ScriptEvent> script = scriptPath.empty() ? std::vector<ScriptEvent>{} : loadScript(scriptPath);
+
+        SeekBarState state;
+        state.isPlaying = true;
+        state.isCursorVisible = false;
+        if (!mediaPath.empty()) {
+            state.content = loadContent(mediaPath);
+        }
+        const double duration = state.content ? state.content->duration : SeekBarContent::placeholder()->duration;
+        // By default the stream ends when the cursor reaches the end of the media
+        const long frameCount = frames.value_or(
+            static_cast<long>(std::ceil(std::max(duration - start, 0.0) / speed * framesPerSecond)));
+
+        HeadlessRenderer renderer{width, height};
+        VideoStreamWriter writer{fd, width, height, format, framesPerSecond};
+
+        size_t nextEvent = 0;
+        double mediaTime = start;
+        const auto begin = std::chrono::steady_clock::now();
+        for (long frame = 0; frame < frameCount; ++frame) {
+            const double streamTime = static_cast<double>(frame) / framesPerSecond;
+            while (nextEvent < script.size() && script[nextEvent].time <= streamTime) {
+                apply(script[nextEvent++], state, mediaTime);
+            }
+
+            state.cursorTime = std::clamp(mediaTime, 0.0, duration);
+            writer.writeFrame(renderer.render(state));
+
+            if (state.isPlaying) {
+                mediaTime += speed / framesPerSecond;
+            }
+        }
+        writer.flush();
+
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        std::cerr << "Streamed " << writer.framesWritten() << " frame(s), " << writer.bytesWritten() << " bytes in "
+                  << elapsed << " s";
+        if (elapsed > 0.0) {
+            std::cerr << " (" << writer.framesWritten() / elapsed << " frames/s)";
+        }
+        std::cerr << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Streaming failed: " << e.what() << std::endl;
+        status = EXIT_FAILURE;
+    }
+
+    if (fd != STDOUT_FILENO) {
+        ::close(fd);
+    }
+    return status;
+}
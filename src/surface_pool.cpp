@@ -0,0 +1,48 @@
+#include "surface_pool.h"
+
+#include "include/core/SkSurface.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+SurfacePool::SurfacePool(const size_t capacity)
+    : _capacity{std::max<size_t>(capacity, 1)}
+    , _allocations{0} {
+}
+
+sk_sp<SkSurface> SurfacePool::acquire(const int width, const int height) {
+    const SkISize size = backingSize(width, height);
+
+    auto found = std::find_if(_surfaces.begin(), _surfaces.end(), [&size](const sk_sp<SkSurface>& surface) {
+        return surface->width() == size.width() && surface->height() == size.height();
+    });
+    if (found != _surfaces.end()) {
+        // Move to the most recently used end
+        std::rotate(found, found + 1, _surfaces.end());
+        return _surfaces.back();
+    }
+
+    auto surface = SkSurfaces::Raster(
+        SkImageInfo::Make(size.width(), size.height(), kRGBA_8888_SkColorType, kPremul_SkAlphaType));
+    if (!surface) {
+        throw std::runtime_error("Failed to create pooled raster surface");
+    }
+    _allocations++;
+
+    if (_surfaces.size() >= _capacity) {
+        _surfaces.erase(_surfaces.begin());
+    }
+    _surfaces.push_back(surface);
+    return surface;
+}
+
+SkISize SurfacePool::backingSize(const int width, const int height) {
+    return SkISize::Make(
+        static_cast<int>(std::bit_ceil(static_cast<unsigned>(std::max(width, 1)))),
+        static_cast<int>(std::bit_ceil(static_cast<unsigned>(std::max(height, 1)))));
+}
+
+uint64_t SurfacePool::allocations() const {
+    return _allocations;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
+
+#include <cstdint>
+#include <vector>
+
+class SkSurface;
+
+// Raster surfaces with power-of-two dimensions. A window being resized keeps getting the same backing
+// store until it crosses the next power of two, so dragging the window edge does not allocate.
+// Callers draw into the top-left width x height corner of the returned surface.
+class SurfacePool {
+public:
+    explicit SurfacePool(const size_t capacity = 2);
+
+    sk_sp<SkSurface> acquire(const int width, const int height);
+
+    static SkISize backingSize(const int width, const int height);
+    uint64_t allocations() const;
+
+private:
+    std::vector<sk_sp<SkSurface>> _surfaces; // Least recently used first
+    size_t _capacity;
+    uint64_t _allocations;
+};
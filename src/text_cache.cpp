@@ -0,0 +1,86 @@
+#include "text_cache.h"
+
+#include "include/core/SkFont.h"
+#include "include/core/SkTypeface.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+size_t hashKey(std::string_view text, const uint32_t typefaceId, const float size) {
+    size_t hash = std::hash<std::string_view>{}(text);
+    hash ^= std::hash<uint32_t>{}(typefaceId) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<float>{}(size) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+} // namespace
+
+size_t TextCache::KeyHash::operator()(const Key& key) const {
+    return hashKey(key.text, key.typefaceId, key.size);
+}
+
+size_t TextCache::KeyHash::operator()(const KeyView& key) const {
+    return hashKey(key.text, key.typefaceId, key.size);
+}
+
+bool TextCache::KeyEqual::operator()(const Key& lhs, const Key& rhs) const {
+    return lhs.text == rhs.text && lhs.typefaceId == rhs.typefaceId && lhs.size == rhs.size;
+}
+
+bool TextCache::KeyEqual::operator()(const KeyView& lhs, const Key& rhs) const {
+    return lhs.text == rhs.text && lhs.typefaceId == rhs.typefaceId && lhs.size == rhs.size;
+}
+
+bool TextCache::KeyEqual::operator()(const Key& lhs, const KeyView& rhs) const {
+    return (*this)(rhs, lhs);
+}
+
+TextCache::TextCache(const size_t capacity)
+    : _capacity{std::max<size_t>(capacity, 1)} {
+}
+
+const TextCache::Entry& TextCache::get(std::string_view text, const SkFont& font) {
+    const uint32_t typefaceId = font.getTypeface() ? font.getTypeface()->uniqueID() : 0;
+    const KeyView view{text, typefaceId, font.getSize()};
+
+    if (auto it = _entries.find(view); it != _entries.end()) {
+        _stats.hits++;
+        _recency.splice(_recency.begin(), _recency, it->second.recency);
+        return it->second.entry;
+    }
+
+    _stats.misses++;
+    // Media with more chapters than fit keeps the labels hovered last
+    if (_entries.size() >= _capacity) {
+        _entries.erase(*_recency.back());
+        _recency.pop_back();
+    }
+
+    Slot slot;
+    font.measureText(text.data(), text.size(), SkTextEncoding::kUTF8, &slot.entry.bounds);
+    slot.entry.blob = SkTextBlob::MakeFromText(text.data(), text.size(), font, SkTextEncoding::kUTF8);
+
+    auto [it, inserted] = _entries.emplace(Key{std::string{text}, typefaceId, font.getSize()}, std::move(slot));
+    _recency.push_front(&it->first);
+    it->second.recency = _recency.begin();
+    return it->second.entry;
+}
+
+const TextCacheStats& TextCache::stats() const {
+    return _stats;
+}
+
+size_t TextCache::size() const {
+    return _entries.size();
+}
+
+size_t TextCache::capacity() const {
+    return _capacity;
+}
+
+void TextCache::clear() {
+    _entries.clear();
+    _recency.clear();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkTextBlob.h"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+class SkFont;
+
+struct TextCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+// Shaped text blobs keyed by (text, typeface, size), so repeated labels are never shaped or measured twice.
+// Holds at most capacity entries and evicts the least recently used one when full.
+class TextCache {
+public:
+    struct Entry {
+        sk_sp<SkTextBlob> blob;
+        SkRect bounds; // Same as SkFont::measureText bounds, relative to the text origin
+    };
+
+    explicit TextCache(const size_t capacity = 4096);
+
+    // The entry stays valid until capacity other labels have been looked up since its last use
+    const Entry& get(std::string_view text, const SkFont& font);
+
+    const TextCacheStats& stats() const;
+    size_t size() const;
+    size_t capacity() const;
+    void clear();
+
+private:
+    struct Key {
+        std::string text;
+        uint32_t typefaceId;
+        float size;
+    };
+
+    struct KeyView {
+        std::string_view text;
+        uint32_t typefaceId;
+        float size;
+    };
+
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(const Key& key) const;
+        size_t operator()(const KeyView& key) const;
+    };
+
+    struct KeyEqual {
+        using is_transparent = void;
+        bool operator()(const Key& lhs, const Key& rhs) const;
+        bool operator()(const KeyView& lhs, const Key& rhs) const;
+        bool operator()(const Key& lhs, const KeyView& rhs) const;
+    };
+
+    using RecencyList = std::list<const Key*>;
+
+    struct Slot {
+        Entry entry;
+        RecencyList::iterator recency;
+    };
+
+    std::unordered_map<Key, Slot, KeyHash, KeyEqual> _entries;
+    RecencyList _recency; // Most recently used first, points at the keys of _entries
+    size_t _capacity;
+    TextCacheStats _stats;
+};
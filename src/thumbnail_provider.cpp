@@ -0,0 +1,195 @@
+#include "thumbnail_provider.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkSamplingOptions.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+constexpr int prefetchDistance = 2; // Sheets decoded ahead in the drag direction
+
+StoryboardInfo StoryboardInfo::loadFromFile(const std::filesystem::path& descriptor) {
+    std::ifstream file{descriptor};
+    if (!file) {
+        throw std::runtime_error("Failed to open storyboard descriptor: " + descriptor.string());
+    }
+
+    StoryboardInfo info;
+    info.directory = descriptor.parent_path();
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        const auto separator = line.find('=');
+        if (separator == std::string::npos) {
+            throw std::runtime_error("Invalid storyboard descriptor line: " + line);
+        }
+        const std::string key = line.substr(0, separator);
+        const std::string value = line.substr(separator + 1);
+
+        if (key == "pattern") {
+            info.sheetPattern = value;
+        } else if (key == "frame_width") {
+            info.frameWidth = std::stoi(value);
+        } else if (key == "frame_height") {
+            info.frameHeight = std::stoi(value);
+        } else if (key == "columns") {
+            info.columns = std::stoi(value);
+        } else if (key == "rows") {
+            info.rows = std::stoi(value);
+        } else if (key == "interval") {
+            info.secondsPerFrame = std::stod(value);
+        } else {
+            throw std::runtime_error("Unknown storyboard descriptor key: " + key);
+        }
+    }
+
+    if (info.frameWidth <= 0 || info.frameHeight <= 0 || info.columns <= 0 || info.rows <= 0
+        || info.secondsPerFrame <= 0.0 || info.sheetPattern.find("{}") == std::string::npos) {
+        throw std::runtime_error("Invalid storyboard descriptor: " + descriptor.string());
+    }
+    return info;
+}
+
+ThumbnailProvider::ThumbnailProvider(StoryboardInfo info, const size_t cacheCapacity, const size_t threadCount)
+    : _info{std::move(info)}
+    , _cacheCapacity{std::max<size_t>(1, cacheCapacity)}
+    , _hasReadySheets{false}
+    , _pool{threadCount} {
+}
+
+std::optional<Thumbnail> ThumbnailProvider::thumbnailAt(const double time) {
+    const int frame = static_cast<int>(std::max(0.0, time) / _info.secondsPerFrame);
+    const int sheetIndex = sheetIndexAt(time);
+    const int cell = frame % (_info.columns * _info.rows);
+
+    sk_sp<SkImage> sheet;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if (auto it = _sheetLookup.find(sheetIndex); it != _sheetLookup.end()) {
+            _sheets.splice(_sheets.begin(), _sheets, it->second);
+            sheet = it->second->second;
+        }
+    }
+
+    if (!sheet) {
+        requestSheet(sheetIndex);
+        return std::nullopt;
+    }
+
+    const SkRect source = SkRect::MakeXYWH(
+        (cell % _info.columns) * _info.frameWidth,
+        (cell / _info.columns) * _info.frameHeight,
+        _info.frameWidth,
+        _info.frameHeight);
+    return Thumbnail{std::move(sheet), source};
+}
+
+void ThumbnailProvider::prefetch(const double time, const int direction) {
+    const int sheetIndex = sheetIndexAt(time);
+    requestSheet(sheetIndex);
+
+    if (direction == 0) {
+        requestSheet(sheetIndex - 1);
+        requestSheet(sheetIndex + 1);
+        return;
+    }
+    for (int i = 1; i <= prefetchDistance; ++i) {
+        requestSheet(sheetIndex + (direction > 0 ? i : -i));
+    }
+}
+
+bool ThumbnailProvider::draw(SkCanvas* canvas, const double time, const SkRect& destination) {
+    const auto thumbnail = thumbnailAt(time);
+    if (!thumbnail) {
+        return false;
+    }
+
+    canvas->drawImageRect(
+        thumbnail->sheet,
+        thumbnail->source,
+        destination,
+        SkSamplingOptions{SkFilterMode::kLinear},
+        nullptr,
+        SkCanvas::kStrict_SrcRectConstraint);
+    return true;
+}
+
+bool ThumbnailProvider::takeReadySheets() {
+    return _hasReadySheets.exchange(false);
+}
+
+void ThumbnailProvider::setOnSheetReady(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock{_mutex};
+    _onSheetReady = std::move(callback);
+}
+
+const StoryboardInfo& ThumbnailProvider::info() const {
+    return _info;
+}
+
+int ThumbnailProvider::sheetIndexAt(const double time) const {
+    const int frame = static_cast<int>(std::max(0.0, time) / _info.secondsPerFrame);
+    return frame / (_info.columns * _info.rows);
+}
+
+std::filesystem::path ThumbnailProvider::sheetPath(const int index) const {
+    std::string name = _info.sheetPattern;
+    name.replace(name.find("{}"), 2, std::to_string(index));
+    return _info.directory / name;
+}
+
+void ThumbnailProvider::requestSheet(const int index) {
+    if (index < 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        if (_sheetLookup.contains(index) || _pendingSheets.contains(index) || _failedSheets.contains(index)) {
+            return;
+        }
+        _pendingSheets.insert(index);
+    }
+
+    _pool.submit([this, index]() { decodeSheet(index); });
+}
+
+void ThumbnailProvider::decodeSheet(const int index) {
+    // SkData maps the file instead of reading it, the decoder pulls pages in as it goes
+    sk_sp<SkData> data = SkData::MakeFromFileName(sheetPath(index).c_str());
+    sk_sp<SkImage> sheet = data ? SkImages::DeferredFromEncodedData(data) : nullptr;
+    if (sheet) {
+        sheet = sheet->makeRasterImage(nullptr);
+    }
+
+    std::function<void()> onSheetReady;
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _pendingSheets.erase(index);
+
+        if (!sheet) {
+            // Past the last sheet or a broken file, do not keep retrying on every hover
+            _failedSheets.insert(index);
+            return;
+        }
+
+        _sheets.emplace_front(index, std::move(sheet));
+        _sheetLookup[index] = _sheets.begin();
+        while (_sheets.size() > _cacheCapacity) {
+            _sheetLookup.erase(_sheets.back().first);
+            _sheets.pop_back();
+        }
+        onSheetReady = _onSheetReady;
+    }
+
+    _hasReadySheets = true;
+    if (onSheetReady) {
+        onSheetReady();
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "thread_pool.h"
+
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+class SkCanvas;
+class SkImage;
+
+// Layout of storyboard sprite sheets: every sheet is a grid of frames, one frame per secondsPerFrame
+struct StoryboardInfo {
+    std::filesystem::path directory;
+    std::string sheetPattern = "sheet_{}.jpg"; // "{}" is replaced with the sheet index
+    int frameWidth = 160;
+    int frameHeight = 90;
+    int columns = 10;
+    int rows = 10;
+    double secondsPerFrame = 2.0;
+
+    // Reads key=value lines (pattern, frame_width, frame_height, columns, rows, interval),
+    // sheets are looked up next to the descriptor file
+    static StoryboardInfo loadFromFile(const std::filesystem::path& descriptor);
+};
+
+struct Thumbnail {
+    sk_sp<SkImage> sheet;
+    SkRect source;
+};
+
+// Serves hover preview frames from storyboard sprite sheets. Sheets are memory-mapped and decoded on
+// worker threads into a bounded LRU cache, so lookups from the render thread never block on decoding.
+class ThumbnailProvider {
+public:
+    ThumbnailProvider(StoryboardInfo info, const size_t cacheCapacity = 8, const size_t threadCount = 2);
+
+    std::optional<Thumbnail> thumbnailAt(const double time);
+    void prefetch(const double time, const int direction);
+    bool draw(SkCanvas* canvas, const double time, const SkRect& destination);
+
+    // Returns true once after one or more sheets finished decoding since the previous call
+    bool takeReadySheets();
+    // Called from a worker thread whenever a sheet finished decoding
+    void setOnSheetReady(std::function<void()> callback);
+
+    const StoryboardInfo& info() const;
+
+private:
+    using SheetList = std::list<std::pair<int, sk_sp<SkImage>>>;
+
+    int sheetIndexAt(const double time) const;
+    std::filesystem::path sheetPath(const int index) const;
+    void requestSheet(const int index);
+    void decodeSheet(const int index);
+
+    StoryboardInfo _info;
+    size_t _cacheCapacity;
+
+    std::mutex _mutex;
+    SheetList _sheets; // Most recently used first
+    std::unordered_map<int, SheetList::iterator> _sheetLookup;
+    std::unordered_set<int> _pendingSheets;
+    std::unordered_set<int> _failedSheets;
+    std::function<void()> _onSheetReady;
+    std::atomic<bool> _hasReadySheets;
+
+    ThreadPool _pool; // Declared last, so workers are joined before the cache is destroyed
+};
@@ -0,0 +1,58 @@
+#include "time_glyphs.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPoint.h"
+
+TimeGlyphs::TimeGlyphs(const SkFont& font)
+    : _font{font} {
+    _slots.fill(-1);
+    _font.textToGlyphs(characters.data(), characters.size(), SkTextEncoding::kUTF8, _glyphs.data(), _glyphs.size());
+    _font.getWidthsBounds(_glyphs.data(), _glyphs.size(), _advances.data(), _bounds.data(), nullptr);
+
+    for (size_t i = 0; i < characters.size(); ++i) {
+        _slots[static_cast<unsigned char>(characters[i])] = static_cast<int8_t>(i);
+    }
+}
+
+int TimeGlyphs::slot(const char character) const {
+    const auto index = static_cast<unsigned char>(character);
+    return index < _slots.size() ? _slots[index] : -1;
+}
+
+SkRect TimeGlyphs::measure(std::string_view text) const {
+    SkRect bounds = SkRect::MakeEmpty();
+    float penX = 0.0f;
+
+    for (const char character : text) {
+        const int index = slot(character);
+        if (index < 0) {
+            continue;
+        }
+        if (!_bounds[index].isEmpty()) {
+            bounds.join(_bounds[index].makeOffset(penX, 0.0f));
+        }
+        penX += _advances[index];
+    }
+    return bounds;
+}
+
+void TimeGlyphs::draw(SkCanvas* canvas, std::string_view text, const float x, const float y, const SkPaint& paint) const {
+    std::array<SkGlyphID, maxTextLength> glyphs;
+    std::array<SkPoint, maxTextLength> positions;
+    int count = 0;
+    float penX = 0.0f;
+
+    for (const char character : text.substr(0, maxTextLength)) {
+        const int index = slot(character);
+        if (index < 0) {
+            continue;
+        }
+        glyphs[count] = _glyphs[index];
+        positions[count] = SkPoint::Make(penX, 0.0f);
+        penX += _advances[index];
+        ++count;
+    }
+
+    canvas->drawGlyphs(count, glyphs.data(), positions.data(), SkPoint::Make(x, y), _font, paint);
+}
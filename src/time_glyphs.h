@@ -0,0 +1,35 @@
+#pragma once
+
+#include "include/core/SkFont.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkTypes.h"
+
+#include <array>
+#include <string_view>
+
+class SkCanvas;
+class SkPaint;
+
+// Glyph IDs, advances and bounds of the characters used by time labels ("0-9", ":", "/", " "),
+// resolved once per font. Time strings are laid out from these tables with no shaping or allocation;
+// other characters are skipped and draw() stops after maxTextLength characters.
+class TimeGlyphs {
+public:
+    static constexpr size_t maxTextLength = 64;
+
+    explicit TimeGlyphs(const SkFont& font);
+
+    SkRect measure(std::string_view text) const; // Same as SkFont::measureText bounds
+    void draw(SkCanvas* canvas, std::string_view text, const float x, const float y, const SkPaint& paint) const;
+
+private:
+    static constexpr std::string_view characters = "0123456789:/ ";
+
+    int slot(const char character) const;
+
+    SkFont _font;
+    std::array<int8_t, 128> _slots;
+    std::array<SkGlyphID, characters.size()> _glyphs;
+    std::array<float, characters.size()> _advances;
+    std::array<SkRect, characters.size()> _bounds;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one writer thread to one reader thread without locks. The writer fills
+// back() and publishes it, the reader picks up the newest published value with update(); values
+// published in between are skipped. Neither side ever waits for the other.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer();
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer thread
+    T& back();
+    void publish();
+
+    // Reader thread; returns true when front() changed
+    bool update();
+    const T& front() const;
+
+private:
+    static constexpr uint8_t indexMask = 0x3;
+    static constexpr uint8_t freshBit = 0x4; // Set while the middle slot holds a value not read yet
+
+    std::array<T, 3> _slots;
+    uint8_t _back;                  // Owned by the writer
+    std::atomic<uint8_t> _middle;   // Slot index exchanged between the threads
+    uint8_t _front;                 // Owned by the reader
+};
+
+template <typename T>
+TripleBuffer<T>::TripleBuffer()
+    : _back{0}
+    , _middle{1}
+    , _front{2} {
+}
+
+template <typename T>
+T& TripleBuffer<T>::back() {
+    return _slots[_back];
+}
+
+template <typename T>
+void TripleBuffer<T>::publish() {
+    _back = _middle.exchange(_back | freshBit, std::memory_order_acq_rel) & indexMask;
+}
+
+template <typename T>
+bool TripleBuffer<T>::update() {
+    if (!(_middle.load(std::memory_order_relaxed) & freshBit)) {
+        return false;
+    }
+    _front = _middle.exchange(_front, std::memory_order_acq_rel) & indexMask;
+    return true;
+}
+
+template <typename T>
+const T& TripleBuffer<T>::front() const {
+    return _slots[_front];
+}
@@ -1,10 +1,65 @@
 #include "utils.h"
 
-std::string formatTime(const double timeInSeconds) {
-    int minutes = static_cast<int>(timeInSeconds) / 60;
-    int seconds = static_cast<int>(timeInSeconds) % 60;
+#include <cmath>
+#include <cstdint>
 
-    char buffer[6];
-    snprintf(buffer, sizeof(buffer), "%02d:%02d", minutes, seconds);
-    return std::string{buffer};
+namespace {
+
+constexpr int64_t maxFormattedSeconds = 999999999LL * 3600; // Keeps hours within the buffer
+
+// Appends value zero-padded to minDigits, returns the new write position
+char* appendNumber(char* out, int64_t value, const int minDigits) {
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+
+    while (count < minDigits) {
+        digits[count++] = '0';
+    }
+    while (count > 0) {
+        *out++ = digits[--count];
+    }
+    return out;
+}
+
+} // namespace
+
+std::string_view formatTime(const double timeInSeconds, char* buffer, const size_t bufferSize) {
+    if (bufferSize == 0) {
+        return {};
+    }
+
+    int64_t totalSeconds = 0;
+    if (std::isfinite(timeInSeconds) && timeInSeconds > 0.0) {
+        totalSeconds = timeInSeconds >= static_cast<double>(maxFormattedSeconds)
+            ? maxFormattedSeconds
+            : static_cast<int64_t>(timeInSeconds);
+    }
+
+    const int64_t hours = totalSeconds / 3600;
+    const int64_t minutes = (totalSeconds / 60) % 60;
+    const int64_t seconds = totalSeconds % 60;
+
+    char text[timeBufferSize];
+    char* end = text;
+    if (hours > 0) {
+        end = appendNumber(end, hours, 1);
+        *end++ = ':';
+    }
+    end = appendNumber(end, minutes, 2);
+    *end++ = ':';
+    end = appendNumber(end, seconds, 2);
+
+    size_t length = static_cast<size_t>(end - text);
+    if (length > bufferSize - 1) {
+        length = bufferSize - 1;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        buffer[i] = text[i];
+    }
+    buffer[length] = '\0';
+    return {buffer, length};
 }
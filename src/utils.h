@@ -1,5 +1,11 @@
 #pragma once
 
-#include <string>
+#include <cstddef>
+#include <string_view>
 
-std::string formatTime(const double timeInSeconds);
+// Large enough for any time formatTime produces, including the terminating null
+constexpr size_t timeBufferSize = 24;
+
+// Writes "MM:SS" below one hour and "H:MM:SS" from one hour on into buffer without allocating.
+// Output is null-terminated and truncated to fit; returns a view of the written characters.
+std::string_view formatTime(const double timeInSeconds, char* buffer, const size_t bufferSize);
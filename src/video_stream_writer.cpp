@@ -0,0 +1,147 @@
+#include "video_stream_writer.h"
+#include "color_convert.h"
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+constexpr size_t minBufferBytes = 4 * 1024 * 1024; // Several Y4M frames per write at 960x640
+constexpr char y4mFrameHeader[] = "FRAME\n";
+
+VideoStreamWriter::VideoStreamWriter(int fd, int width, int height, VideoStreamFormat format, int framesPerSecond)
+    : _fd{fd}
+    , _width{width}
+    , _height{height}
+    , _format{format}
+    , _bufferSize{0}
+    , _framesWritten{0}
+    , _bytesWritten{0} {
+    if (width <= 0 || height <= 0 || framesPerSecond <= 0) {
+        throw std::runtime_error("Invalid video stream size or frame rate");
+    }
+
+    const size_t chromaBytes = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+    const size_t frameBytes = format == VideoStreamFormat::Y4m
+        ? sizeof(y4mFrameHeader) - 1 + static_cast<size_t>(width) * height + 2 * chromaBytes
+        : static_cast<size_t>(width) * height * 4;
+    _buffer.resize(std::max(minBufferBytes, frameBytes));
+
+    if (format == VideoStreamFormat::Y4m) {
+        // Limited range BT.601, matching convertRgbaToI420
+        const std::string header = "YUV4MPEG2 W" + std::to_string(width) + " H" + std::to_string(height) + " F"
+            + std::to_string(framesPerSecond) + ":1 Ip A1:1 C420jpeg XYSCSS=420JPEG XCOLORRANGE=LIMITED\n";
+        append(header.data(), header.size());
+    }
+}
+
+VideoStreamWriter::~VideoStreamWriter() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+    }
+}
+
+void VideoStreamWriter::writeFrame(const SkPixmap& pixmap) {
+    if (pixmap.width() != _width || pixmap.height() != _height || pixmap.info().bytesPerPixel() != 4) {
+        throw std::runtime_error("Frame does not match the video stream size");
+    }
+
+    if (_format == VideoStreamFormat::Y4m) {
+        writeY4mFrame(pixmap);
+    } else {
+        writeRgbaFrame(pixmap);
+    }
+    ++_framesWritten;
+}
+
+void VideoStreamWriter::flush() {
+    writeOut(nullptr, 0);
+}
+
+uint64_t VideoStreamWriter::framesWritten() const {
+    return _framesWritten;
+}
+
+uint64_t VideoStreamWriter::bytesWritten() const {
+    return _bytesWritten;
+}
+
+void VideoStreamWriter::append(const void* data, size_t size) {
+    std::memcpy(_buffer.data() + _bufferSize, data, size);
+    _bufferSize += size;
+}
+
+void VideoStreamWriter::writeY4mFrame(const SkPixmap& pixmap) {
+    const size_t lumaBytes = static_cast<size_t>(_width) * _height;
+    const size_t chromaWidth = (_width + 1) / 2;
+    const size_t chromaBytes = chromaWidth * ((_height + 1) / 2);
+    const size_t frameBytes = sizeof(y4mFrameHeader) - 1 + lumaBytes + 2 * chromaBytes;
+    if (_bufferSize + frameBytes > _buffer.size()) {
+        flush();
+    }
+
+    append(y4mFrameHeader, sizeof(y4mFrameHeader) - 1);
+    uint8_t* planes = _buffer.data() + _bufferSize;
+    convertRgbaToI420(
+        static_cast<const uint8_t*>(pixmap.addr()), pixmap.rowBytes(), _width, _height,
+        {planes, planes + lumaBytes, planes + lumaBytes + chromaBytes, static_cast<size_t>(_width), chromaWidth});
+    _bufferSize += lumaBytes + 2 * chromaBytes;
+}
+
+void VideoStreamWriter::writeRgbaFrame(const SkPixmap& pixmap) {
+    const size_t packedRowBytes = static_cast<size_t>(_width) * 4;
+    if (pixmap.rowBytes() == packedRowBytes) {
+        writeOut(pixmap.addr(), packedRowBytes * _height);
+        return;
+    }
+
+    if (_bufferSize + packedRowBytes * _height > _buffer.size()) {
+        flush();
+    }
+    for (int row = 0; row < _height; ++row) {
+        append(pixmap.addr(0, row), packedRowBytes);
+    }
+}
+
+void VideoStreamWriter::writeOut(const void* extra, size_t extraSize) {
+    iovec chunks[2] = {
+        {_buffer.data(), _bufferSize},
+        {const_cast<void*>(extra), extraSize}};
+    iovec* pending = chunks;
+    int pendingCount = extraSize > 0 ? 2 : 1;
+
+    while (pendingCount > 0) {
+        if (pending->iov_len == 0) {
+            ++pending;
+            --pendingCount;
+            continue;
+        }
+
+        const ssize_t written = ::writev(_fd, pending, pendingCount);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            _bufferSize = 0;
+            throw std::runtime_error(std::string{"Failed to write video stream: "} + std::strerror(errno));
+        }
+        _bytesWritten += static_cast<uint64_t>(written);
+
+        // Pipes accept partial writes, continue after whatever went through
+        size_t remaining = static_cast<size_t>(written);
+        while (pendingCount > 0 && remaining >= pending->iov_len) {
+            remaining -= pending->iov_len;
+            ++pending;
+            --pendingCount;
+        }
+        if (pendingCount > 0) {
+            pending->iov_base = static_cast<uint8_t*>(pending->iov_base) + remaining;
+            pending->iov_len -= remaining;
+        }
+    }
+    _bufferSize = 0;
+}
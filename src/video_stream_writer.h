@@ -0,0 +1,48 @@
+#pragma once
+
+#include "include/core/SkPixmap.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class VideoStreamFormat {
+    Y4m,    // YUV4MPEG2 with I420 frames, readable by ffmpeg/x264 as is
+    Rgba    // Headerless RGBA frames, the consumer has to be told size, rate and pixel format
+};
+
+// Writes rendered frames to a file descriptor (stdout, a pipe or a file). Y4M frames are converted
+// straight into a large output buffer that goes out in few big writes; tightly packed RGBA frames are
+// written from the pixmap itself without being copied.
+class VideoStreamWriter {
+public:
+    // fd is not owned and has to stay open until the writer is destroyed
+    VideoStreamWriter(int fd, int width, int height, VideoStreamFormat format, int framesPerSecond);
+    ~VideoStreamWriter(); // Flushes, errors are dropped; call flush() to see them
+
+    VideoStreamWriter(const VideoStreamWriter&) = delete;
+    VideoStreamWriter& operator=(const VideoStreamWriter&) = delete;
+
+    // Throws std::runtime_error when the consumer went away or the size does not match
+    void writeFrame(const SkPixmap& pixmap);
+    void flush();
+
+    uint64_t framesWritten() const;
+    uint64_t bytesWritten() const;
+
+private:
+    void append(const void* data, size_t size);
+    void writeY4mFrame(const SkPixmap& pixmap);
+    void writeRgbaFrame(const SkPixmap& pixmap);
+    // Sends the buffer followed by extra bytes, in one system call when possible
+    void writeOut(const void* extra, size_t extraSize);
+
+    int _fd;
+    int _width;
+    int _height;
+    VideoStreamFormat _format;
+    std::vector<uint8_t> _buffer; // Capacity is fixed, _bufferSize bytes are pending
+    size_t _bufferSize;
+    uint64_t _framesWritten;
+    uint64_t _bytesWritten;
+};
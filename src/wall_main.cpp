@@ -0,0 +1,129 @@
+#include "seek_bar_wall.h"
+
+#include "include/core/SkStream.h"
+#include "include/encode/SkPngEncoder.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+constexpr int defaultColumns = 8;
+constexpr int defaultRows = 8;
+constexpr int defaultCellWidth = 480;
+constexpr int defaultCellHeight = 200;
+constexpr int defaultFrames = 120;
+constexpr double playbackStep = 1.0; // Seconds every simulated stream advances per frame
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--columns N] [--rows N] [--cell-width W] [--cell-height H]\n"
+              << "       [--frames N] [--threads N] [--output wall.png]\n"
+              << "\n"
+              << "Renders a wall of seek bars, every stream advancing its cursor each frame, and reports throughput.\n";
+}
+
+// Streams start at different points and a few of them are still loading or hovered, like a real dashboard
+SeekBarState streamState(const size_t stream, const int frame) {
+    SeekBarState state;
+    const double duration = SeekBarContent::placeholder()->duration;
+
+    if (stream % 7 == 3) {
+        state.loadState = LoadState::Loading;
+        state.loadingProgress = static_cast<double>((stream * 13 + frame) % 100) / 100.0;
+        return state;
+    }
+
+    state.cursorTime = std::fmod(stream * 37.0 + frame * playbackStep, duration);
+    state.isPlaying = stream % 3 != 0;
+    state.isMuted = stream % 4 == 0;
+    state.isCursorVisible = stream % 5 == 0;
+    if (state.isCursorVisible) {
+        state.hoveredChapter = static_cast<int>((stream + frame / 30) % 4);
+    }
+    return state;
+}
+
+bool writePng(const SkPixmap& pixmap, const std::string& outputPath) {
+    SkFILEWStream stream{outputPath.c_str()};
+    if (!stream.isValid()) {
+        return false;
+    }
+
+    SkPngEncoder::Options options;
+    options.fZLibLevel = 1;
+    options.fFilterFlags = SkPngEncoder::FilterFlag::kSub;
+    return SkPngEncoder::Encode(&stream, pixmap, options);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int columns = defaultColumns;
+    int rows = defaultRows;
+    int cellWidth = defaultCellWidth;
+    int cellHeight = defaultCellHeight;
+    int frames = defaultFrames;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    std::string outputPath;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--columns" && i + 1 < argc) {
+            columns = std::atoi(argv[++i]);
+        } else if (arg == "--rows" && i + 1 < argc) {
+            rows = std::atoi(argv[++i]);
+        } else if (arg == "--cell-width" && i + 1 < argc) {
+            cellWidth = std::atoi(argv[++i]);
+        } else if (arg == "--cell-height" && i + 1 < argc) {
+            cellHeight = std::atoi(argv[++i]);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frames = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (columns <= 0 || rows <= 0 || cellWidth <= 0 || cellHeight <= 0 || frames <= 0 || threads <= 0) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        SeekBarWall wall{columns, rows, cellWidth, cellHeight, static_cast<size_t>(threads)};
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            for (size_t stream = 0; stream < wall.size(); ++stream) {
+                wall.applyState(stream, streamState(stream, frame));
+            }
+            wall.render();
+        }
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const SeekBarWallStats& stats = wall.stats();
+        std::cout << "Rendered " << frames << " frame(s) of " << wall.size() << " seek bar(s) on " << threads
+                  << " thread(s) in " << elapsed << " s";
+        if (elapsed > 0.0) {
+            std::cout << " (" << frames / elapsed << " frames/s, " << stats.recordedCells / elapsed << " bars/s)";
+        }
+        std::cout << ", " << stats.rasterizedTiles << " tile(s) rasterized" << std::endl;
+
+        if (!outputPath.empty() && !writePng(wall.render(), outputPath)) {
+            std::cerr << "Failed to write " << outputPath << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << "Wall rendering failed: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
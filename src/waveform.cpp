@@ -0,0 +1,292 @@
+#include "waveform.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t peaksPerTask = 1024; // Level 0 peaks computed by one pool task
+constexpr uint16_t wavFormatPcm = 1;
+constexpr uint16_t wavFormatFloat = 3;
+constexpr uint16_t wavFormatExtensible = 0xFFFE;
+
+enum class SampleFormat {
+    Int16,
+    Int24,
+    Float32
+};
+
+struct WavLayout {
+    SampleFormat format;
+    uint32_t sampleRate;
+    uint16_t channels;
+    uint16_t bytesPerFrame;
+    std::string_view samples; // Contents of the data chunk, whole frames only
+};
+
+// WAV is little endian throughout
+template <typename T>
+T readLittleEndian(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+WavLayout parseWavHeader(const std::string_view data) {
+    std::optional<WavLayout> layout;
+    uint16_t formatTag = 0;
+    uint16_t bitsPerSample = 0;
+    size_t offset = 12;
+
+    while (offset + 8 <= data.size()) {
+        const std::string_view id = data.substr(offset, 4);
+        const uint32_t size = readLittleEndian<uint32_t>(data.data() + offset + 4);
+        const size_t body = offset + 8;
+
+        if (id == "fmt " && size >= 16 && body + size <= data.size()) {
+            formatTag = readLittleEndian<uint16_t>(data.data() + body);
+            bitsPerSample = readLittleEndian<uint16_t>(data.data() + body + 14);
+            if (formatTag == wavFormatExtensible && size >= 26) {
+                formatTag = readLittleEndian<uint16_t>(data.data() + body + 24); // First bytes of the sub format GUID
+            }
+
+            layout = WavLayout{};
+            layout->channels = readLittleEndian<uint16_t>(data.data() + body + 2);
+            layout->sampleRate = readLittleEndian<uint32_t>(data.data() + body + 4);
+            layout->bytesPerFrame = readLittleEndian<uint16_t>(data.data() + body + 12);
+        } else if (id == "data" && layout) {
+            // Streamed files leave the size at its maximum, the data then runs to the end of the file
+            const size_t available = std::min<size_t>(size, data.size() - body);
+            layout->samples = data.substr(body, available - available % std::max<uint16_t>(layout->bytesPerFrame, 1));
+            break;
+        }
+        offset = body + size + (size & 1);
+    }
+
+    if (!layout || layout->samples.data() == nullptr) {
+        throw std::runtime_error("WAV file has no fmt or data chunk");
+    }
+    if (formatTag == wavFormatPcm && bitsPerSample == 16) {
+        layout->format = SampleFormat::Int16;
+    } else if (formatTag == wavFormatPcm && bitsPerSample == 24) {
+        layout->format = SampleFormat::Int24;
+    } else if (formatTag == wavFormatFloat && bitsPerSample == 32) {
+        layout->format = SampleFormat::Float32;
+    } else {
+        throw std::runtime_error("Unsupported WAV sample format, expected 16/24-bit PCM or 32-bit float");
+    }
+    if (layout->channels == 0 || layout->sampleRate == 0
+        || layout->bytesPerFrame != layout->channels * (bitsPerSample / 8)) {
+        throw std::runtime_error("Invalid WAV fmt chunk");
+    }
+    return *layout;
+}
+
+PeakRange peakInt16(const char* data, const size_t sampleCount) {
+    int16_t low = std::numeric_limits<int16_t>::max();
+    int16_t high = std::numeric_limits<int16_t>::min();
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    __m128i lows = _mm_set1_epi16(low);
+    __m128i highs = _mm_set1_epi16(high);
+    for (; i + 8 <= sampleCount; i += 8) {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 2));
+        lows = _mm_min_epi16(lows, samples);
+        highs = _mm_max_epi16(highs, samples);
+    }
+    alignas(16) int16_t lanes[8];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), lows);
+    low = *std::min_element(std::begin(lanes), std::end(lanes));
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), highs);
+    high = *std::max_element(std::begin(lanes), std::end(lanes));
+#endif
+
+    for (; i < sampleCount; ++i) {
+        const int16_t sample = readLittleEndian<int16_t>(data + i * 2);
+        low = std::min(low, sample);
+        high = std::max(high, sample);
+    }
+    return {low / 32768.0f, high / 32768.0f};
+}
+
+PeakRange peakFloat32(const char* data, const size_t sampleCount) {
+    float low = std::numeric_limits<float>::max();
+    float high = std::numeric_limits<float>::lowest();
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    __m128 lows = _mm_set1_ps(low);
+    __m128 highs = _mm_set1_ps(high);
+    for (; i + 4 <= sampleCount; i += 4) {
+        const __m128 samples = _mm_loadu_ps(reinterpret_cast<const float*>(data + i * 4));
+        lows = _mm_min_ps(lows, samples);
+        highs = _mm_max_ps(highs, samples);
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, lows);
+    low = *std::min_element(std::begin(lanes), std::end(lanes));
+    _mm_store_ps(lanes, highs);
+    high = *std::max_element(std::begin(lanes), std::end(lanes));
+#endif
+
+    for (; i < sampleCount; ++i) {
+        const float sample = readLittleEndian<float>(data + i * 4);
+        low = std::min(low, sample);
+        high = std::max(high, sample);
+    }
+    return {std::clamp(low, -1.0f, 1.0f), std::clamp(high, -1.0f, 1.0f)};
+}
+
+PeakRange peakInt24(const char* data, const size_t sampleCount) {
+    int32_t low = std::numeric_limits<int32_t>::max();
+    int32_t high = std::numeric_limits<int32_t>::min();
+    for (size_t i = 0; i < sampleCount; ++i) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(data + i * 3);
+        // Place the 24 bits at the top and shift back down to sign-extend
+        const int32_t sample = static_cast<int32_t>(
+            (static_cast<uint32_t>(bytes[0]) << 8) | (static_cast<uint32_t>(bytes[1]) << 16)
+            | (static_cast<uint32_t>(bytes[2]) << 24)) >> 8;
+        low = std::min(low, sample);
+        high = std::max(high, sample);
+    }
+    return {low / 8388608.0f, high / 8388608.0f};
+}
+
+PeakRange peakOf(const WavLayout& layout, const char* data, const size_t sampleCount) {
+    switch (layout.format) {
+    case SampleFormat::Int16:
+        return peakInt16(data, sampleCount);
+    case SampleFormat::Int24:
+        return peakInt24(data, sampleCount);
+    case SampleFormat::Float32:
+        return peakFloat32(data, sampleCount);
+    }
+    return {};
+}
+
+PeakRange merge(const PeakRange& lhs, const PeakRange& rhs) {
+    return {std::min(lhs.min, rhs.min), std::max(lhs.max, rhs.max)};
+}
+
+} // namespace
+
+bool Waveform::isWav(const std::string_view data) {
+    return data.size() >= 12 && data.substr(0, 4) == "RIFF" && data.substr(8, 4) == "WAVE";
+}
+
+std::shared_ptr<const Waveform> Waveform::fromWav(
+    const std::string_view data,
+    ThreadPool& pool,
+    const std::function<bool(double)>& onProgress) {
+    const WavLayout layout = parseWavHeader(data);
+    const uint64_t frameCount = layout.samples.size() / layout.bytesPerFrame;
+    const size_t peakCount = (frameCount + framesPerPeak - 1) / framesPerPeak;
+    const size_t bytesPerPeak = framesPerPeak * layout.bytesPerFrame;
+    const size_t sampleSize = layout.bytesPerFrame / layout.channels;
+
+    // Channels are interleaved, so one peak over a run of frames covers all of them at once
+    std::vector<PeakRange> basePeaks(peakCount);
+    std::atomic<bool> isCancelled{false};
+    std::vector<std::future<void>> tasks;
+    tasks.reserve((peakCount + peaksPerTask - 1) / peaksPerTask);
+
+    for (size_t first = 0; first < peakCount; first += peaksPerTask) {
+        tasks.push_back(pool.submit([&, first]() {
+            const size_t last = std::min(peakCount, first + peaksPerTask);
+            for (size_t i = first; i < last && !isCancelled; ++i) {
+                const size_t offset = i * bytesPerPeak;
+                const size_t size = std::min(bytesPerPeak, layout.samples.size() - offset);
+                basePeaks[i] = peakOf(layout, layout.samples.data() + offset, size / sampleSize);
+            }
+        }));
+    }
+
+    // Every task has to finish before returning, they reference this frame
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        tasks[i].get();
+        if (!isCancelled && !onProgress(static_cast<double>(i + 1) / tasks.size())) {
+            isCancelled = true;
+        }
+    }
+    if (isCancelled) {
+        throw std::runtime_error("Loading cancelled");
+    }
+
+    return std::shared_ptr<const Waveform>{new Waveform{layout.sampleRate, frameCount, std::move(basePeaks)}};
+}
+
+Waveform::Waveform(const uint32_t sampleRate, const uint64_t frameCount, std::vector<PeakRange> basePeaks)
+    : _sampleRate{sampleRate}
+    , _frameCount{frameCount} {
+    _levels.push_back(std::move(basePeaks));
+    while (_levels.back().size() > 1) {
+        const auto& below = _levels.back();
+        std::vector<PeakRange> level((below.size() + 1) / 2);
+        for (size_t i = 0; i < level.size(); ++i) {
+            level[i] = 2 * i + 1 < below.size() ? merge(below[2 * i], below[2 * i + 1]) : below[2 * i];
+        }
+        _levels.push_back(std::move(level));
+    }
+}
+
+double Waveform::duration() const {
+    return static_cast<double>(_frameCount) / _sampleRate;
+}
+
+uint32_t Waveform::sampleRate() const {
+    return _sampleRate;
+}
+
+size_t Waveform::levelCount() const {
+    return _levels.size();
+}
+
+void Waveform::peaks(const double startTime, const double endTime, std::span<PeakRange> columns) const {
+    if (columns.empty()) {
+        return;
+    }
+    if (_levels.front().empty() || endTime <= startTime) {
+        std::fill(columns.begin(), columns.end(), PeakRange{});
+        return;
+    }
+
+    // Coarsest level whose entries are still no wider than a column
+    const double basePeaksPerSecond = static_cast<double>(_sampleRate) / framesPerPeak;
+    const double columnDuration = (endTime - startTime) / columns.size();
+    const double basePeaksPerColumn = columnDuration * basePeaksPerSecond;
+    size_t level = 0;
+    while (level + 1 < _levels.size() && static_cast<double>(size_t{2} << level) <= basePeaksPerColumn) {
+        ++level;
+    }
+
+    const auto& peaks = _levels[level];
+    const double peaksPerSecond = basePeaksPerSecond / static_cast<double>(size_t{1} << level);
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const double columnStart = startTime + i * columnDuration;
+        const size_t first = static_cast<size_t>(std::max(0.0, std::floor(columnStart * peaksPerSecond)));
+        const size_t last = std::min(
+            peaks.size(),
+            std::max(first + 1, static_cast<size_t>(std::max(0.0, std::ceil((columnStart + columnDuration) * peaksPerSecond)))));
+
+        if (first >= peaks.size()) {
+            columns[i] = PeakRange{};
+            continue;
+        }
+        PeakRange range = peaks[first];
+        for (size_t j = first + 1; j < last; ++j) {
+            range = merge(range, peaks[j]);
+        }
+        columns[i] = range;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "thread_pool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// Lowest and highest sample in a range, normalized to -1.0..1.0
+struct PeakRange {
+    float min = 0.0f;
+    float max = 0.0f;
+};
+
+// Amplitude envelope of an audio file kept as a peak pyramid: level 0 holds one peak per
+// framesPerPeak frames (all channels combined), every following level merges two neighbours of
+// the level below. Any time range then maps to at most a few entries of one level, so querying
+// the envelope costs time proportional to the number of columns, not to the number of samples.
+class Waveform {
+public:
+    static constexpr size_t framesPerPeak = 256;
+
+    static bool isWav(std::string_view data);
+    // Extracts peaks from a 16/24-bit PCM or 32-bit float WAV image on the pool. onProgress gets
+    // the fraction done and returns false to cancel, which throws std::runtime_error.
+    static std::shared_ptr<const Waveform> fromWav(
+        std::string_view data,
+        ThreadPool& pool,
+        const std::function<bool(double)>& onProgress);
+
+    double duration() const; // Seconds
+    uint32_t sampleRate() const;
+    size_t levelCount() const;
+
+    // Fills every column with the peaks of its share of [startTime, endTime)
+    void peaks(const double startTime, const double endTime, std::span<PeakRange> columns) const;
+
+private:
+    Waveform(const uint32_t sampleRate, const uint64_t frameCount, std::vector<PeakRange> basePeaks);
+
+    uint32_t _sampleRate;
+    uint64_t _frameCount;
+    std::vector<std::vector<PeakRange>> _levels; // _levels[0] is the finest
+};
@@ -0,0 +1,181 @@
+#include "widget_tree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+constexpr double cellSize = 32.0; // Logical units per grid cell, about a button
+
+bool WidgetRect::contains(const double px, const double py) const {
+    return px >= x && px <= x + width && py >= y && py <= y + height;
+}
+
+bool WidgetRect::isEmpty() const {
+    return width <= 0.0 || height <= 0.0;
+}
+
+WidgetRect WidgetRect::united(const WidgetRect& other) const {
+    if (isEmpty()) {
+        return other;
+    }
+    if (other.isEmpty()) {
+        return *this;
+    }
+    const double left = std::min(x, other.x);
+    const double top = std::min(y, other.y);
+    const double right = std::max(x + width, other.x + other.width);
+    const double bottom = std::max(y + height, other.y + other.height);
+    return {left, top, right - left, bottom - top};
+}
+
+WidgetTree::WidgetTree()
+    : _width{0.0}
+    , _height{0.0}
+    , _columns{0}
+    , _rows{0} {
+    _byKind.fill(-1);
+}
+
+void WidgetTree::clear() {
+    _widgets.clear();
+    _byKind.fill(-1);
+    _cellStarts.clear();
+    _cellWidgets.clear();
+    _width = 0.0;
+    _height = 0.0;
+    _columns = 0;
+    _rows = 0;
+}
+
+size_t WidgetTree::add(const WidgetKind kind, const std::optional<size_t> parent, const WidgetRect& bounds, const WidgetRect& hitBounds) {
+    if (parent && *parent >= _widgets.size()) {
+        throw std::runtime_error("Widget parent has to be added first");
+    }
+    const size_t index = _widgets.size();
+    _widgets.push_back({
+        .kind = kind,
+        .parent = parent ? static_cast<int>(*parent) : -1,
+        .bounds = bounds,
+        .hitBounds = hitBounds,
+        .isEnabled = true,
+        .isDirty = false});
+    _byKind[static_cast<size_t>(kind)] = static_cast<int>(index);
+    return index;
+}
+
+void WidgetTree::buildIndex(const double width, const double height) {
+    _width = width;
+    _height = height;
+    _columns = std::max(1, static_cast<int>(std::ceil(width / cellSize)));
+    _rows = std::max(1, static_cast<int>(std::ceil(height / cellSize)));
+    const size_t cellCount = static_cast<size_t>(_columns) * _rows;
+
+    // Cell range each widget covers, clipped to the grid
+    const auto cellRange = [&](const WidgetRect& rect, int& left, int& top, int& right, int& bottom) {
+        left = std::clamp(static_cast<int>(std::floor(rect.x / cellSize)), 0, _columns - 1);
+        top = std::clamp(static_cast<int>(std::floor(rect.y / cellSize)), 0, _rows - 1);
+        right = std::clamp(static_cast<int>(std::floor((rect.x + rect.width) / cellSize)), 0, _columns - 1);
+        bottom = std::clamp(static_cast<int>(std::floor((rect.y + rect.height) / cellSize)), 0, _rows - 1);
+        return !rect.isEmpty() && rect.x <= width && rect.y <= height && rect.x + rect.width >= 0.0 && rect.y + rect.height >= 0.0;
+    };
+
+    // Count, prefix sum, then fill: one allocation per array whatever the widget count
+    _cellStarts.assign(cellCount + 1, 0);
+    for (const auto& widget : _widgets) {
+        int left, top, right, bottom;
+        if (!cellRange(widget.hitBounds, left, top, right, bottom)) {
+            continue;
+        }
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                ++_cellStarts[static_cast<size_t>(row) * _columns + column + 1];
+            }
+        }
+    }
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        _cellStarts[cell + 1] += _cellStarts[cell];
+    }
+
+    _cellWidgets.resize(_cellStarts[cellCount]);
+    std::vector<uint32_t> filled(_cellStarts.begin(), _cellStarts.end() - 1);
+    for (size_t index = 0; index < _widgets.size(); ++index) {
+        int left, top, right, bottom;
+        if (!cellRange(_widgets[index].hitBounds, left, top, right, bottom)) {
+            continue;
+        }
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                _cellWidgets[filled[static_cast<size_t>(row) * _columns + column]++] = static_cast<uint16_t>(index);
+            }
+        }
+    }
+}
+
+size_t WidgetTree::size() const {
+    return _widgets.size();
+}
+
+const Widget& WidgetTree::widget(const size_t index) const {
+    return _widgets[index];
+}
+
+std::optional<size_t> WidgetTree::find(const WidgetKind kind) const {
+    if (_byKind[static_cast<size_t>(kind)] < 0) {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(_byKind[static_cast<size_t>(kind)]);
+}
+
+std::optional<size_t> WidgetTree::hitTest(const double x, const double y) const {
+    const int cell = cellIndex(x, y);
+    if (cell < 0) {
+        return std::nullopt;
+    }
+
+    // Later widgets are children or drawn on top, so the cell list is searched from its end
+    for (uint32_t i = _cellStarts[cell + 1]; i-- > _cellStarts[cell];) {
+        const size_t index = _cellWidgets[i];
+        if (_widgets[index].hitBounds.contains(x, y) && isEnabledWithAncestors(index)) {
+            return index;
+        }
+    }
+    return std::nullopt;
+}
+
+void WidgetTree::setEnabled(const size_t index, const bool enabled) {
+    _widgets[index].isEnabled = enabled;
+}
+
+void WidgetTree::markDirty(const size_t index) {
+    _widgets[index].isDirty = true;
+}
+
+WidgetRect WidgetTree::takeDirtyRect() {
+    WidgetRect dirty;
+    for (auto& widget : _widgets) {
+        if (widget.isDirty) {
+            dirty = dirty.united(widget.bounds);
+            widget.isDirty = false;
+        }
+    }
+    return dirty;
+}
+
+bool WidgetTree::isEnabledWithAncestors(size_t index) const {
+    for (int current = static_cast<int>(index); current >= 0; current = _widgets[current].parent) {
+        if (!_widgets[current].isEnabled) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int WidgetTree::cellIndex(const double x, const double y) const {
+    if (_columns == 0 || x < 0.0 || y < 0.0 || x > _width || y > _height) {
+        return -1;
+    }
+    // The far edges of the indexed area still belong to the last cells
+    const int column = std::min(static_cast<int>(x / cellSize), _columns - 1);
+    const int row = std::min(static_cast<int>(y / cellSize), _rows - 1);
+    return row * _columns + column;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+enum class WidgetKind {
+    Bar,            // Seek area, takes presses and drags
+    Chapters,       // Child of the bar, a hit resolves to a chapter through ChapterIndex
+    PlayButton,
+    SkipButton,
+    VolumeButton,
+    Count
+};
+
+// Logical units, like SeekBarLayout
+struct WidgetRect {
+    double x = 0.0;
+    double y = 0.0;
+    double width = 0.0;
+    double height = 0.0;
+
+    bool contains(const double px, const double py) const; // Edges count as inside
+    bool isEmpty() const;
+    WidgetRect united(const WidgetRect& other) const;
+};
+
+struct Widget {
+    WidgetKind kind;
+    int parent;             // Index of the parent widget, -1 at the top level
+    WidgetRect bounds;      // What the widget draws, reported as its invalidation rect
+    WidgetRect hitBounds;   // What takes the pointer, may reach beyond the drawn bounds
+    bool isEnabled;         // Disabled widgets (and their children) are skipped by hit testing
+    bool isDirty;
+};
+
+// Retained widgets of one seek bar with a uniform grid over the window for hit testing, so pointer
+// dispatch only looks at the few widgets overlapping the cell under the pointer. Children are added
+// after their parents and win hit tests over them. Every kind appears at most once.
+class WidgetTree {
+public:
+    WidgetTree();
+
+    void clear();
+    size_t add(const WidgetKind kind, const std::optional<size_t> parent, const WidgetRect& bounds, const WidgetRect& hitBounds);
+    // Call once all widgets are added; hit tests outside width x height find nothing
+    void buildIndex(const double width, const double height);
+
+    size_t size() const;
+    const Widget& widget(const size_t index) const;
+    std::optional<size_t> find(const WidgetKind kind) const;
+    // Topmost enabled widget under the point
+    std::optional<size_t> hitTest(const double x, const double y) const;
+
+    void setEnabled(const size_t index, const bool enabled);
+    void markDirty(const size_t index);
+    // Union of the bounds of widgets marked dirty since the last call, clears the flags
+    WidgetRect takeDirtyRect();
+
+private:
+    bool isEnabledWithAncestors(size_t index) const;
+    int cellIndex(const double x, const double y) const; // -1 outside the grid
+
+    std::vector<Widget> _widgets;
+    std::array<int, static_cast<size_t>(WidgetKind::Count)> _byKind; // -1 for kinds not in the tree
+    // Widgets overlapping grid cell c are _cellWidgets[_cellStarts[c] .. _cellStarts[c + 1]), in insertion order
+    std::vector<uint32_t> _cellStarts;
+    std::vector<uint16_t> _cellWidgets;
+    double _width;
+    double _height;
+    int _columns;
+    int _rows;
+};